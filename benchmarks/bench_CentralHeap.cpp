@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <vector>
+
+#include "gc_malloc/CentralHeap.hpp"
+#include "gc_malloc/PageGroup.hpp"
+
+// =====================================================================
+// 基准 1: 单次 acquire/release (Acquire & Release)
+// 释放后的 span 会立刻与相邻空闲页合并，下一次申请再拆分出来，
+// 覆盖了加锁、best-fit 查找、拆分与合并的完整路径。
+// =====================================================================
+
+static void BM_CentralHeap_AcquireRelease(benchmark::State& state) {
+    CentralHeap& heap = CentralHeap::GetInstance();
+    const size_t num_pages = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        PageGroup* group = heap.acquire_pages(num_pages);
+        benchmark::DoNotOptimize(group);
+        heap.release_pages(group);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * num_pages * CentralHeap::kPageSize);
+}
+BENCHMARK(BM_CentralHeap_AcquireRelease)->ArgName("pages")->RangeMultiplier(2)->Range(1, CentralHeap::kMaxPages);
+
+// 对照组：同样大小的页对齐内存直接向 glibc 申请
+static void BM_Glibc_AlignedAllocFree(benchmark::State& state) {
+    const size_t bytes = static_cast<size_t>(state.range(0)) * CentralHeap::kPageSize;
+
+    for (auto _ : state) {
+        void* p = std::aligned_alloc(CentralHeap::kPageSize, bytes);
+        benchmark::DoNotOptimize(p);
+        std::free(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_Glibc_AlignedAllocFree)->ArgName("pages")->RangeMultiplier(2)->Range(1, CentralHeap::kMaxPages);
+
+
+// =====================================================================
+// 基准 2: 批量 acquire 后逆序 release (Batch Acquire & Release)
+// 一次性持有多个 span，使地址链表变长，测量插入点查找与邻居合并的成本。
+// =====================================================================
+
+static void BM_CentralHeap_BatchAcquireRelease(benchmark::State& state) {
+    CentralHeap& heap = CentralHeap::GetInstance();
+    const int batch = static_cast<int>(state.range(0));
+    const size_t num_pages = 4;
+    std::vector<PageGroup*> groups(batch);
+
+    for (auto _ : state) {
+        for (int i = 0; i < batch; ++i) {
+            groups[i] = heap.acquire_pages(num_pages);
+        }
+        // 隔一个释放一个，先制造碎片，再释放剩余部分触发合并
+        for (int i = 0; i < batch; i += 2) {
+            heap.release_pages(groups[i]);
+        }
+        for (int i = 1; i < batch; i += 2) {
+            heap.release_pages(groups[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_CentralHeap_BatchAcquireRelease)->ArgName("batch")->RangeMultiplier(4)->Range(4, 256);
@@ -0,0 +1,272 @@
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <vector>
+
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/SizeClassInfo.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+
+// 每轮批量操作的块数。ThreadHeap 的释放要等到 garbage_collect 才真正回收，
+// 因此所有对照都以“分配一批、释放一批、回收一次”为单位进行。
+static constexpr int kBatch = 64;
+
+// 恰好填满该类别一个块的最大请求大小
+static size_t SizeForClass(const benchmark::State& state) {
+    return SizeClassInfo::get_block_size_for_index(static_cast<size_t>(state.range(0))) - sizeof(BlockHeader);
+}
+
+static void ApplySizeClassArgs(benchmark::internal::Benchmark* b) {
+    b->ArgName("class");
+    b->DenseRange(0, kNumSizeClasses - 1);
+}
+
+
+// =====================================================================
+// 基准 1: 分配/释放成对操作 (Alloc/Free Pairs)
+// =====================================================================
+
+static void BM_ThreadHeap_AllocFreePair(benchmark::State& state) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+    const size_t size = SizeForClass(state);
+    void* pointers[kBatch];
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBatch; ++i) {
+            pointers[i] = th->allocate(size);
+            benchmark::DoNotOptimize(pointers[i]);
+        }
+        for (int i = 0; i < kBatch; ++i) {
+            ThreadHeap::deallocate(pointers[i]);
+        }
+        th->garbage_collect();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_ThreadHeap_AllocFreePair)->Apply(ApplySizeClassArgs);
+
+static void BM_Glibc_AllocFreePair(benchmark::State& state) {
+    const size_t size = SizeForClass(state);
+    void* pointers[kBatch];
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBatch; ++i) {
+            pointers[i] = std::malloc(size);
+            benchmark::DoNotOptimize(pointers[i]);
+        }
+        for (int i = 0; i < kBatch; ++i) {
+            std::free(pointers[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Glibc_AllocFreePair)->Apply(ApplySizeClassArgs);
+
+
+// =====================================================================
+// 基准 2: 单独测量 allocate 快路径 (Allocate Only)
+// =====================================================================
+
+static void BM_ThreadHeap_Allocate(benchmark::State& state) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+    const size_t size = SizeForClass(state);
+    void* pointers[kBatch];
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBatch; ++i) {
+            pointers[i] = th->allocate(size);
+            benchmark::DoNotOptimize(pointers[i]);
+        }
+
+        state.PauseTiming();
+        for (int i = 0; i < kBatch; ++i) {
+            ThreadHeap::deallocate(pointers[i]);
+        }
+        th->garbage_collect();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_ThreadHeap_Allocate)->Apply(ApplySizeClassArgs);
+
+static void BM_Glibc_Malloc(benchmark::State& state) {
+    const size_t size = SizeForClass(state);
+    void* pointers[kBatch];
+
+    for (auto _ : state) {
+        for (int i = 0; i < kBatch; ++i) {
+            pointers[i] = std::malloc(size);
+            benchmark::DoNotOptimize(pointers[i]);
+        }
+
+        state.PauseTiming();
+        for (int i = 0; i < kBatch; ++i) {
+            std::free(pointers[i]);
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Glibc_Malloc)->Apply(ApplySizeClassArgs);
+
+
+// =====================================================================
+// 基准 3: 单独测量 deallocate (Deallocate Only)
+// deallocate 只是一次 release 写，真正的回收成本计入 garbage_collect。
+// =====================================================================
+
+static void BM_ThreadHeap_Deallocate(benchmark::State& state) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+    const size_t size = SizeForClass(state);
+    void* pointers[kBatch];
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (int i = 0; i < kBatch; ++i) {
+            pointers[i] = th->allocate(size);
+        }
+        state.ResumeTiming();
+
+        for (int i = 0; i < kBatch; ++i) {
+            ThreadHeap::deallocate(pointers[i]);
+        }
+
+        state.PauseTiming();
+        th->garbage_collect();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_ThreadHeap_Deallocate)->Apply(ApplySizeClassArgs);
+
+static void BM_Glibc_Free(benchmark::State& state) {
+    const size_t size = SizeForClass(state);
+    void* pointers[kBatch];
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (int i = 0; i < kBatch; ++i) {
+            pointers[i] = std::malloc(size);
+        }
+        state.ResumeTiming();
+
+        for (int i = 0; i < kBatch; ++i) {
+            std::free(pointers[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_Glibc_Free)->Apply(ApplySizeClassArgs);
+
+
+// =====================================================================
+// 基准 4: refill 成本 (Refill)
+// 每轮恰好耗尽一个新的 PageGroup：一次 refill 加上其中全部块的弹出。
+// 本轮分配的块要等基准结束才释放，以保证每轮都走 refill，因此限制迭代次数。
+// =====================================================================
+
+static void BM_ThreadHeap_Refill(benchmark::State& state) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+    const size_t index = static_cast<size_t>(state.range(0));
+    const size_t size = SizeForClass(state);
+    const size_t blocks_per_group = SizeClassInfo::get_pages_to_acquire_for_index(index) * CentralHeap::kPageSize /
+                                    SizeClassInfo::get_block_size_for_index(index);
+
+    // 一直分配到该类别恰好发生一次 refill，此后每轮 blocks_per_group 次分配
+    // 都会耗尽当前 PageGroup 并触发下一次 refill
+    std::vector<void*> held;
+    const uintptr_t refills_before = th->counters().refill_count[index].load();
+    while (th->counters().refill_count[index].load() == refills_before) {
+        held.push_back(th->allocate(size));
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < blocks_per_group; ++i) {
+            void* p = th->allocate(size);
+            benchmark::DoNotOptimize(p);
+            held.push_back(p);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * blocks_per_group);
+    state.counters["refills"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+
+    for (void* p : held) {
+        ThreadHeap::deallocate(p);
+    }
+    th->garbage_collect();
+}
+BENCHMARK(BM_ThreadHeap_Refill)->Apply(ApplySizeClassArgs)->Iterations(256);
+
+
+// =====================================================================
+// 基准 5: GC 扫描成本 (Sweep Cost per Live Object)
+// 托管链表上保留 live 个存活对象，每轮只释放 kBatch 个新对象，
+// 只计时 garbage_collect，得到每个被扫描块的平均成本。
+// =====================================================================
+
+static void BM_ThreadHeap_GarbageCollect(benchmark::State& state) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+    const size_t live = static_cast<size_t>(state.range(0));
+    const size_t size = 64;
+
+    std::vector<void*> live_objects;
+    live_objects.reserve(live);
+    for (size_t i = 0; i < live; ++i) {
+        live_objects.push_back(th->allocate(size));
+    }
+
+    void* pointers[kBatch];
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (int i = 0; i < kBatch; ++i) {
+            pointers[i] = th->allocate(size);
+        }
+        for (int i = 0; i < kBatch; ++i) {
+            ThreadHeap::deallocate(pointers[i]);
+        }
+        state.ResumeTiming();
+
+        th->garbage_collect();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (live + kBatch));
+    state.counters["live"] = static_cast<double>(live);
+
+    for (void* p : live_objects) {
+        ThreadHeap::deallocate(p);
+    }
+    th->garbage_collect();
+}
+BENCHMARK(BM_ThreadHeap_GarbageCollect)->ArgName("live")->Arg(0)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+
+
+// =====================================================================
+// 基准 6: 大对象路径 (Large Objects)
+// =====================================================================
+
+static void BM_ThreadHeap_LargeAllocFree(benchmark::State& state) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+    const size_t size = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        void* p = th->allocate(size);
+        benchmark::DoNotOptimize(p);
+        ThreadHeap::deallocate(p);
+        th->garbage_collect();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThreadHeap_LargeAllocFree)->ArgName("bytes")->RangeMultiplier(4)->Range(32 << 10, 512 << 10);
+
+static void BM_Glibc_LargeMallocFree(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        void* p = std::malloc(size);
+        benchmark::DoNotOptimize(p);
+        std::free(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Glibc_LargeMallocFree)->ArgName("bytes")->RangeMultiplier(4)->Range(32 << 10, 512 << 10);
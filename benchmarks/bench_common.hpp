@@ -0,0 +1,108 @@
+#ifndef GC_MALLOC_BENCH_COMMON_HPP
+#define GC_MALLOC_BENCH_COMMON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "gc_malloc/ThreadHeap.hpp"
+
+// =====================================================================
+// 分配器适配层 (Allocator Adapters)
+// 基准代码只通过 allocate/deallocate 两个静态函数访问分配器，
+// 同一份负载可以分别跑在 gc_malloc 与 glibc malloc 上。
+// =====================================================================
+
+struct GcMallocAllocator {
+    static constexpr const char* kName = "gc_malloc";
+
+    // ThreadHeap 的释放要由所属线程的 garbage_collect 才能回收，
+    // 这里在分配路径上每隔固定次数回收一次，模拟应用的周期性回收。
+    static constexpr unsigned kCollectInterval = 256;
+
+    static void* allocate(size_t size) {
+        static thread_local unsigned alloc_count = 0;
+        ThreadHeap* heap = ThreadHeap::GetInstance();
+        if (++alloc_count % kCollectInterval == 0) {
+            heap->garbage_collect();
+        }
+        return heap->allocate(size);
+    }
+
+    static void deallocate(void* ptr) {
+        ThreadHeap::deallocate(ptr);
+    }
+
+    // 立即回收本线程已释放的块
+    static void collect() {
+        ThreadHeap::GetInstance()->garbage_collect();
+    }
+
+    // 线程结束前回收一次，尽量把本线程持有的空闲块还回去
+    static void thread_exit() {
+        ThreadHeap::GetInstance()->garbage_collect();
+    }
+};
+
+struct GlibcAllocator {
+    static constexpr const char* kName = "glibc";
+
+    static void* allocate(size_t size) {
+        return std::malloc(size);
+    }
+
+    static void deallocate(void* ptr) {
+        std::free(ptr);
+    }
+
+    static void collect() {}
+
+    static void thread_exit() {}
+};
+
+
+// =====================================================================
+// 进程内存统计 (Process Memory)
+// =====================================================================
+
+// 从 /proc/self/status 读取形如 "VmRSS:  1234 kB" 的字段，返回字节数
+inline size_t ReadProcStatusBytes(const char* field) {
+    FILE* f = std::fopen("/proc/self/status", "r");
+    if (f == nullptr) {
+        return 0;
+    }
+    char line[256];
+    size_t value_kb = 0;
+    const size_t field_len = std::strlen(field);
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+        if (std::strncmp(line, field, field_len) == 0 && line[field_len] == ':') {
+            value_kb = std::strtoull(line + field_len + 1, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(f);
+    return value_kb * 1024;
+}
+
+inline size_t CurrentRssBytes() {
+    return ReadProcStatusBytes("VmRSS");
+}
+
+inline size_t PeakRssBytes() {
+    return ReadProcStatusBytes("VmHWM");
+}
+
+// 向 /proc/self/clear_refs 写入 5 会把 VmHWM 重置为当前 RSS，
+// 使每一轮测量都能得到自己的峰值。内核不支持时峰值会跨轮次累计。
+inline bool ResetPeakRss() {
+    FILE* f = std::fopen("/proc/self/clear_refs", "w");
+    if (f == nullptr) {
+        return false;
+    }
+    const bool ok = std::fputs("5", f) >= 0;
+    return std::fclose(f) == 0 && ok;
+}
+
+#endif // GC_MALLOC_BENCH_COMMON_HPP
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "gc_malloc/Allocator.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+
+// 标准容器分别使用 Allocator<T>（gc_malloc）与 std::allocator<T>（glibc）。
+// gc_malloc 的释放要等到 garbage_collect 才回收，因此每轮结束时回收一次，
+// 回收耗时计入结果。
+
+template <typename T>
+struct UseGcMalloc {
+    using type = Allocator<T>;
+    static void collect() { ThreadHeap::GetInstance()->garbage_collect(); }
+};
+
+template <typename T>
+struct UseGlibc {
+    using type = std::allocator<T>;
+    static void collect() {}
+};
+
+
+// =====================================================================
+// 基准 1: vector 逐个 push_back 增长 (Vector Growth)
+// =====================================================================
+
+template <template <typename> class Policy>
+static void BM_VectorGrowth(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        {
+            std::vector<int, typename Policy<int>::type> v;
+            for (int i = 0; i < n; ++i) {
+                v.push_back(i);
+            }
+            benchmark::DoNotOptimize(v.data());
+        }
+        Policy<int>::collect();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_VectorGrowth, UseGcMalloc)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_VectorGrowth, UseGlibc)->Arg(1 << 10)->Arg(1 << 16);
+
+
+// =====================================================================
+// 基准 2: list 插入与整体销毁 (List Build/Teardown)
+// =====================================================================
+
+template <template <typename> class Policy>
+static void BM_ListBuild(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        {
+            std::list<int, typename Policy<int>::type> l;
+            for (int i = 0; i < n; ++i) {
+                l.push_back(i);
+            }
+            benchmark::DoNotOptimize(&l.back());
+        }
+        Policy<int>::collect();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_ListBuild, UseGcMalloc)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_ListBuild, UseGlibc)->Arg(1 << 10)->Arg(1 << 14);
+
+
+// =====================================================================
+// 基准 3: unordered_map 插入（含 rehash）与销毁 (Hash Map Build)
+// =====================================================================
+
+template <template <typename> class Policy>
+static void BM_UnorderedMapBuild(benchmark::State& state) {
+    using Value = std::pair<const int, int>;
+    using Map = std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, typename Policy<Value>::type>;
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        {
+            Map map;
+            for (int i = 0; i < n; ++i) {
+                map.emplace(i, i);
+            }
+            benchmark::DoNotOptimize(map.size());
+        }
+        Policy<Value>::collect();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_UnorderedMapBuild, UseGcMalloc)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_UnorderedMapBuild, UseGlibc)->Arg(1 << 10)->Arg(1 << 14);
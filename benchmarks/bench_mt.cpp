@@ -0,0 +1,420 @@
+// 多线程可扩展性基准：Larson、threadtest、xmalloc 式生产者/消费者与 cache-scratch。
+//
+// 每个负载依次以 1, 2, 4, ..., N 个线程运行，分别报告吞吐 (ops/sec)、
+// 采样得到的 p50/p99 单次操作延迟，以及该轮运行的峰值 RSS。
+//
+// 用法: bench_mt [--threads N] [--ops N] [--workload larson|threadtest|xmalloc|cache-scratch|all]
+//                [--allocator gc_malloc|glibc|all] [--csv]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+
+namespace {
+
+struct Options {
+    int max_threads = 0;
+    size_t ops_per_thread = 200000;
+    std::string workload = "all";
+    std::string allocator = "all";
+    bool csv = false;
+};
+
+struct RunResult {
+    double ops_per_sec;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    size_t peak_rss;
+};
+
+
+// =====================================================================
+// 延迟采样与运行框架 (Latency Sampling & Runner)
+// =====================================================================
+
+// 每 8 次操作计时一次，避免 now() 本身的开销淹没被测操作
+class LatencySampler {
+public:
+    static constexpr unsigned kSampleMask = 7;
+
+    template <typename Op>
+    auto run(Op&& op) -> decltype(op()) {
+        if ((++counter_ & kSampleMask) != 0) {
+            return op();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        auto result = op();
+        const auto end = std::chrono::steady_clock::now();
+        samples_.push_back(static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        return result;
+    }
+
+    std::vector<uint32_t>& samples() { return samples_; }
+
+private:
+    unsigned counter_ = 0;
+    std::vector<uint32_t> samples_;
+};
+
+// 启动 num_threads 个线程执行 worker(tid, round, sampler)，返回值为该线程完成的操作数。
+// rounds > 1 时每一轮都重新创建线程，用于模拟 Larson 中服务线程的更替。
+template <typename Worker>
+RunResult Measure(int num_threads, int rounds, Worker&& worker) {
+    ResetPeakRss();
+
+    std::vector<LatencySampler> samplers(num_threads);
+    uint64_t total_ops = 0;
+    double total_seconds = 0;
+
+    for (int round = 0; round < rounds; ++round) {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<uint64_t> ops(num_threads, 0);
+        std::vector<std::thread> threads;
+
+        for (int tid = 0; tid < num_threads; ++tid) {
+            threads.emplace_back([&, tid]() {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                ops[tid] = worker(tid, round, samplers[tid]);
+            });
+        }
+
+        while (ready.load() < num_threads) {
+            std::this_thread::yield();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& t : threads) {
+            t.join();
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        total_seconds += std::chrono::duration<double>(end - start).count();
+        for (uint64_t n : ops) {
+            total_ops += n;
+        }
+    }
+
+    std::vector<uint32_t> all;
+    for (auto& s : samplers) {
+        all.insert(all.end(), s.samples().begin(), s.samples().end());
+    }
+
+    RunResult result{};
+    result.ops_per_sec = total_seconds > 0 ? total_ops / total_seconds : 0;
+    if (!all.empty()) {
+        auto nth = [&](double q) {
+            const size_t k = std::min(all.size() - 1, static_cast<size_t>(q * all.size()));
+            std::nth_element(all.begin(), all.begin() + k, all.end());
+            return static_cast<uint64_t>(all[k]);
+        };
+        result.p50_ns = nth(0.50);
+        result.p99_ns = nth(0.99);
+    }
+    result.peak_rss = PeakRssBytes();
+    return result;
+}
+
+
+// =====================================================================
+// 负载 1: Larson 服务器模拟 (Larson)
+// 每个线程维护一组槽位，随机替换其中的对象；每轮结束后线程退出，
+// 由新线程接手同一组槽位，因此大量对象会在分配线程之外被释放。
+// =====================================================================
+
+template <typename Alloc>
+RunResult RunLarson(int num_threads, const Options& opt) {
+    constexpr size_t kSlotsPerThread = 1000;
+    constexpr size_t kMinSize = 16;
+    constexpr size_t kMaxSize = 512;
+    constexpr int kRounds = 4;
+
+    std::vector<std::vector<void*>> slots(num_threads, std::vector<void*>(kSlotsPerThread, nullptr));
+    const size_t ops_per_round = opt.ops_per_thread / kRounds;
+
+    RunResult r = Measure(num_threads, kRounds, [&](int tid, int round, LatencySampler& sampler) {
+        std::mt19937 rng(tid * 7919 + round);
+        std::uniform_int_distribution<size_t> size_dist(kMinSize, kMaxSize);
+        std::uniform_int_distribution<size_t> slot_dist(0, kSlotsPerThread - 1);
+        std::vector<void*>& mine = slots[tid];
+
+        for (size_t i = 0; i < ops_per_round; ++i) {
+            const size_t slot = slot_dist(rng);
+            const size_t size = size_dist(rng);
+            sampler.run([&]() {
+                if (mine[slot] != nullptr) {
+                    Alloc::deallocate(mine[slot]);
+                }
+                mine[slot] = Alloc::allocate(size);
+                return 0;
+            });
+        }
+        Alloc::thread_exit();
+        return static_cast<uint64_t>(ops_per_round);
+    });
+
+    for (auto& mine : slots) {
+        for (void* p : mine) {
+            if (p != nullptr) {
+                Alloc::deallocate(p);
+            }
+        }
+    }
+    Alloc::thread_exit();
+    return r;
+}
+
+
+// =====================================================================
+// 负载 2: threadtest
+// 各线程互不共享，反复分配一批同尺寸对象后全部释放。
+// =====================================================================
+
+template <typename Alloc>
+RunResult RunThreadTest(int num_threads, const Options& opt) {
+    constexpr size_t kObjects = 100;
+    constexpr size_t kSize = 64;
+
+    return Measure(num_threads, 1, [&](int, int, LatencySampler& sampler) {
+        void* objects[kObjects];
+        const size_t loops = opt.ops_per_thread / (2 * kObjects);
+
+        for (size_t loop = 0; loop < loops; ++loop) {
+            for (size_t i = 0; i < kObjects; ++i) {
+                objects[i] = sampler.run([&]() { return Alloc::allocate(kSize); });
+            }
+            for (size_t i = 0; i < kObjects; ++i) {
+                sampler.run([&]() { Alloc::deallocate(objects[i]); return 0; });
+            }
+        }
+        Alloc::thread_exit();
+        return static_cast<uint64_t>(loops * kObjects * 2);
+    });
+}
+
+
+// =====================================================================
+// 负载 3: xmalloc 式生产者/消费者 (Producer-Consumer)
+// 线程两两配对，偶数号线程分配并通过无锁环形队列交给奇数号线程释放，
+// 所有释放都是跨线程释放。线程数为奇数时最后一个线程自产自销。
+// =====================================================================
+
+class SpscRing {
+public:
+    static constexpr size_t kCapacity = 1024;
+
+    bool push(void* p) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+            return false;
+        }
+        slots_[tail % kCapacity] = p;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void* pop() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        void* p = slots_[head % kCapacity];
+        head_.store(head + 1, std::memory_order_release);
+        return p;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    void* slots_[kCapacity];
+};
+
+template <typename Alloc>
+RunResult RunProducerConsumer(int num_threads, const Options& opt) {
+    constexpr size_t kMinSize = 16;
+    constexpr size_t kMaxSize = 256;
+
+    std::vector<SpscRing> rings((num_threads + 1) / 2);
+    const size_t items = opt.ops_per_thread;
+
+    return Measure(num_threads, 1, [&](int tid, int, LatencySampler& sampler) {
+        std::mt19937 rng(tid);
+        std::uniform_int_distribution<size_t> size_dist(kMinSize, kMaxSize);
+        const bool paired = (tid | 1) < num_threads;
+        SpscRing& ring = rings[tid / 2];
+
+        if (!paired) {
+            for (size_t i = 0; i < items; ++i) {
+                void* p = sampler.run([&]() { return Alloc::allocate(size_dist(rng)); });
+                sampler.run([&]() { Alloc::deallocate(p); return 0; });
+            }
+        } else if (tid % 2 == 0) {
+            for (size_t i = 0; i < items; ++i) {
+                void* p = sampler.run([&]() { return Alloc::allocate(size_dist(rng)); });
+                while (!ring.push(p)) {
+                    std::this_thread::yield();
+                }
+            }
+        } else {
+            for (size_t i = 0; i < items; ++i) {
+                void* p;
+                while ((p = ring.pop()) == nullptr) {
+                    std::this_thread::yield();
+                }
+                sampler.run([&]() { Alloc::deallocate(p); return 0; });
+            }
+        }
+        Alloc::thread_exit();
+        return static_cast<uint64_t>(paired ? items : items * 2);
+    });
+}
+
+
+// =====================================================================
+// 负载 4: cache-scratch
+// 主线程连续分配一批小对象并分发给各线程，各线程释放后反复
+// 分配同尺寸小对象并密集写入。若不同线程拿到同一缓存行上的对象，
+// 吞吐会因伪共享而无法随线程数扩展。
+// =====================================================================
+
+template <typename Alloc>
+RunResult RunCacheScratch(int num_threads, const Options& opt) {
+    constexpr size_t kObjectSize = 8;
+    constexpr int kWritesPerObject = 100;
+
+    std::vector<void*> handoff(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        handoff[i] = Alloc::allocate(kObjectSize);
+    }
+    const size_t iterations = opt.ops_per_thread / 10;
+
+    RunResult r = Measure(num_threads, 1, [&](int tid, int, LatencySampler& sampler) {
+        Alloc::deallocate(handoff[tid]);
+        for (size_t i = 0; i < iterations; ++i) {
+            sampler.run([&]() {
+                volatile char* p = static_cast<volatile char*>(Alloc::allocate(kObjectSize));
+                for (int w = 0; w < kWritesPerObject; ++w) {
+                    p[w % kObjectSize] = static_cast<char>(p[w % kObjectSize] + 1);
+                }
+                Alloc::deallocate(const_cast<char*>(p));
+                return 0;
+            });
+        }
+        Alloc::thread_exit();
+        return static_cast<uint64_t>(iterations);
+    });
+
+    Alloc::thread_exit();
+    return r;
+}
+
+
+// =====================================================================
+// 驱动 (Driver)
+// =====================================================================
+
+struct Workload {
+    const char* name;
+    RunResult (*run_gc)(int, const Options&);
+    RunResult (*run_glibc)(int, const Options&);
+};
+
+const Workload kWorkloads[] = {
+    {"larson", RunLarson<GcMallocAllocator>, RunLarson<GlibcAllocator>},
+    {"threadtest", RunThreadTest<GcMallocAllocator>, RunThreadTest<GlibcAllocator>},
+    {"xmalloc", RunProducerConsumer<GcMallocAllocator>, RunProducerConsumer<GlibcAllocator>},
+    {"cache-scratch", RunCacheScratch<GcMallocAllocator>, RunCacheScratch<GlibcAllocator>},
+};
+
+void PrintRow(const Options& opt, const char* workload, const char* allocator, int threads, const RunResult& r) {
+    if (opt.csv) {
+        std::printf("%s,%s,%d,%.0f,%llu,%llu,%zu\n", workload, allocator, threads, r.ops_per_sec,
+                    static_cast<unsigned long long>(r.p50_ns), static_cast<unsigned long long>(r.p99_ns), r.peak_rss);
+    } else {
+        std::printf("%-14s %-10s %7d %14.0f %10llu %10llu %12.1f\n", workload, allocator, threads, r.ops_per_sec,
+                    static_cast<unsigned long long>(r.p50_ns), static_cast<unsigned long long>(r.p99_ns),
+                    r.peak_rss / (1024.0 * 1024.0));
+    }
+    std::fflush(stdout);
+}
+
+bool ParseArgs(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+
+        if (arg == "--csv") {
+            opt->csv = true;
+        } else if (arg == "--threads" && (value = next()) != nullptr) {
+            opt->max_threads = std::atoi(value);
+        } else if (arg == "--ops" && (value = next()) != nullptr) {
+            opt->ops_per_thread = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--workload" && (value = next()) != nullptr) {
+            opt->workload = value;
+        } else if (arg == "--allocator" && (value = next()) != nullptr) {
+            opt->allocator = value;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--threads N] [--ops N] [--workload larson|threadtest|xmalloc|cache-scratch|all]\n"
+                         "          [--allocator gc_malloc|glibc|all] [--csv]\n", argv[0]);
+            return false;
+        }
+    }
+    if (opt->max_threads <= 0) {
+        opt->max_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return true;
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!ParseArgs(argc, argv, &opt)) {
+        return 1;
+    }
+
+    std::vector<int> thread_counts;
+    for (int t = 1; t < opt.max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(opt.max_threads);
+
+    if (opt.csv) {
+        std::printf("workload,allocator,threads,ops_per_sec,p50_ns,p99_ns,peak_rss_bytes\n");
+    } else {
+        std::printf("%-14s %-10s %7s %14s %10s %10s %12s\n",
+                    "workload", "allocator", "threads", "ops/sec", "p50(ns)", "p99(ns)", "peakRSS(MiB)");
+    }
+
+    for (const Workload& w : kWorkloads) {
+        if (opt.workload != "all" && opt.workload != w.name) {
+            continue;
+        }
+        for (int threads : thread_counts) {
+            if (opt.allocator == "all" || opt.allocator == GcMallocAllocator::kName) {
+                PrintRow(opt, w.name, GcMallocAllocator::kName, threads, w.run_gc(threads, opt));
+            }
+            if (opt.allocator == "all" || opt.allocator == GlibcAllocator::kName) {
+                PrintRow(opt, w.name, GlibcAllocator::kName, threads, w.run_glibc(threads, opt));
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,265 @@
+// RSS 回落基准：模拟一次负载尖峰之后内存能否还给系统。
+//
+// 每个线程先分配一大批随机大小的小对象（尖峰），随机释放其中的绝大部分，
+// 幸存对象零散地分布在各个 PageGroup 中；之后进入稳态，持续在一个小的
+// 工作集上分配/释放，同时让幸存对象分批死亡。工作集的新对象若分散到
+// 稀疏的 PageGroup 中，这些组就无法随幸存者死亡而变空。最后所有线程空闲
+// 略长于一个衰减周期后再回收一次，gc_malloc 在衰减时把 CentralHeap 中零散的
+// 空闲页还给操作系统，RSS 应随持有字节数回落。报告各阶段的存活字节数、
+// gc_malloc 从 CentralHeap 持有的字节数以及进程 RSS。
+//
+// 同一进程中先跑的分配器会影响后跑的 RSS，对比时建议分别运行：
+//   bench_rss --allocator gc_malloc
+//   bench_rss --allocator glibc
+//
+// 用法: bench_rss [--threads N] [--objects N] [--allocator gc_malloc|glibc] [--csv]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <malloc.h>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+
+namespace {
+
+struct Options {
+    int threads = 1;
+    size_t objects_per_thread = 200000;
+    std::string allocator = "gc_malloc";
+    bool csv = false;
+};
+
+constexpr size_t kMinSize = 16;
+constexpr size_t kMaxSize = 512;
+constexpr double kSurvivorFraction = 0.05;     // 尖峰过后保留的对象比例
+constexpr size_t kSteadySteps = 8;             // 稳态阶段的采样次数
+constexpr size_t kOpsPerStepFactor = 1;        // 每个采样间隔的操作数 = 对象数 * 该系数
+constexpr std::chrono::milliseconds kIdleTime(1100);  // 略长于 ThreadHeap 的衰减周期
+
+
+// 主线程与工作线程在各阶段之间同步，主线程在工作线程停下时采样
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int count) : count_(count) {}
+
+    void wait() {
+        const unsigned generation = generation_.load(std::memory_order_acquire);
+        if (waiting_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_) {
+            waiting_.store(0, std::memory_order_relaxed);
+            generation_.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (generation_.load(std::memory_order_acquire) == generation) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    const int count_;
+    std::atomic<int> waiting_{0};
+    std::atomic<unsigned> generation_{0};
+};
+
+
+// 分配器从系统拿到、尚未归还的字节数
+template <typename Alloc>
+size_t HeldBytes();
+
+template <>
+size_t HeldBytes<GlibcAllocator>() {
+    const struct mallinfo2 info = mallinfo2();
+    return info.arena + info.hblkhd;
+}
+
+template <>
+size_t HeldBytes<GcMallocAllocator>() {
+    CentralHeap::Stats stats;
+    CentralHeap::GetInstance().collect_stats(&stats);
+    return stats.pages_in_use * CentralHeap::kPageSize;
+}
+
+
+template <typename Alloc>
+void Run(const Options& opt) {
+    std::atomic<int64_t> live_bytes{0};
+    SpinBarrier barrier(opt.threads + 1);
+
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < opt.threads; ++tid) {
+        threads.emplace_back([&, tid]() {
+            std::mt19937 rng(tid + 1);
+            std::uniform_int_distribution<size_t> size_dist(kMinSize, kMaxSize);
+            std::uniform_real_distribution<double> coin(0.0, 1.0);
+            const size_t n = opt.objects_per_thread;
+            std::vector<void*> objects(n, nullptr);
+            std::vector<size_t> sizes(n, 0);
+            int64_t local_live = 0;
+
+            auto free_slot = [&](size_t i) {
+                Alloc::deallocate(objects[i]);
+                local_live -= sizes[i];
+                objects[i] = nullptr;
+            };
+            auto alloc_slot = [&](size_t i) {
+                sizes[i] = size_dist(rng);
+                objects[i] = Alloc::allocate(sizes[i]);
+                local_live += sizes[i];
+            };
+            auto publish = [&]() {
+                live_bytes.fetch_add(local_live, std::memory_order_relaxed);
+                local_live = 0;
+            };
+
+            barrier.wait();     // baseline
+
+            // 1. 尖峰
+            for (size_t i = 0; i < n; ++i) {
+                alloc_slot(i);
+            }
+            publish();
+            barrier.wait();     // peak
+            barrier.wait();
+
+            // 2. 大规模释放，只留下零散的幸存者
+            for (size_t i = 0; i < n; ++i) {
+                if (coin(rng) >= kSurvivorFraction) {
+                    free_slot(i);
+                }
+            }
+            Alloc::collect();
+            publish();
+            barrier.wait();     // after drain
+            barrier.wait();
+
+            // 3. 稳态：在前 5% 的槽位上持续替换对象，其余槽位的幸存者每个采样间隔死亡 1/kSteadySteps
+            const size_t working_set = static_cast<size_t>(n * kSurvivorFraction);
+            std::uniform_int_distribution<size_t> slot_dist(0, working_set - 1);
+            for (size_t step = 0; step < kSteadySteps; ++step) {
+                for (size_t op = 0; op < n * kOpsPerStepFactor; ++op) {
+                    const size_t i = slot_dist(rng);
+                    if (objects[i] != nullptr) {
+                        free_slot(i);
+                    }
+                    alloc_slot(i);
+                }
+                for (size_t i = working_set + step; i < n; i += kSteadySteps) {
+                    if (objects[i] != nullptr) {
+                        free_slot(i);
+                    }
+                }
+                Alloc::collect();
+                publish();
+                barrier.wait(); // steady sample
+                barrier.wait();
+            }
+
+            // 4. 空闲：幸存者都已死亡，等待一个衰减周期后再回收
+            std::this_thread::sleep_for(kIdleTime);
+            Alloc::collect();
+            barrier.wait();     // idle
+            barrier.wait();
+
+            for (size_t i = 0; i < n; ++i) {
+                if (objects[i] != nullptr) {
+                    free_slot(i);
+                }
+            }
+            publish();
+            Alloc::thread_exit();
+        });
+    }
+
+    auto report = [&](const std::string& phase) {
+        const double mib = 1024.0 * 1024.0;
+        const int64_t live = live_bytes.load(std::memory_order_relaxed);
+        const size_t held = HeldBytes<Alloc>();
+        const size_t rss = CurrentRssBytes();
+        if (opt.csv) {
+            std::printf("%s,%s,%d,%lld,%zu,%zu\n", Alloc::kName, phase.c_str(), opt.threads,
+                        static_cast<long long>(live), held, rss);
+        } else {
+            std::printf("%-10s %-10s %12.1f %12.1f %12.1f\n", Alloc::kName, phase.c_str(),
+                        live / mib, held / mib, rss / mib);
+        }
+        std::fflush(stdout);
+    };
+
+    report("baseline");
+    barrier.wait();
+    barrier.wait();
+    report("peak");
+    barrier.wait();
+    barrier.wait();
+    report("drained");
+    barrier.wait();
+    for (size_t step = 0; step < kSteadySteps; ++step) {
+        barrier.wait();
+        report("steady-" + std::to_string(step + 1));
+        barrier.wait();
+    }
+    barrier.wait();
+    report("idle");
+    barrier.wait();
+
+    for (auto& t : threads) {
+        t.join();
+    }
+    report("exit");
+}
+
+bool ParseArgs(int argc, char** argv, Options* opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+
+        if (arg == "--csv") {
+            opt->csv = true;
+        } else if (arg == "--threads" && (value = next()) != nullptr) {
+            opt->threads = std::max(1, std::atoi(value));
+        } else if (arg == "--objects" && (value = next()) != nullptr) {
+            opt->objects_per_thread = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--allocator" && (value = next()) != nullptr) {
+            opt->allocator = value;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--threads N] [--objects N] [--allocator gc_malloc|glibc] [--csv]\n", argv[0]);
+            return false;
+        }
+    }
+    return opt->objects_per_thread > 0;
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!ParseArgs(argc, argv, &opt)) {
+        return 1;
+    }
+
+    if (opt.csv) {
+        std::printf("allocator,phase,threads,live_bytes,held_bytes,rss_bytes\n");
+    } else {
+        std::printf("%-10s %-10s %12s %12s %12s\n", "allocator", "phase", "live(MiB)", "held(MiB)", "RSS(MiB)");
+    }
+
+    if (opt.allocator == GcMallocAllocator::kName) {
+        Run<GcMallocAllocator>(opt);
+    } else if (opt.allocator == GlibcAllocator::kName) {
+        Run<GlibcAllocator>(opt);
+    } else {
+        std::fprintf(stderr, "unknown allocator: %s\n", opt.allocator.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -16,6 +16,27 @@ public:
     static void* allocate_aligned(size_t size);
     static void deallocate_aligned(void* ptr, size_t size);
 
+    // 文件后端：把 fd 的 [0, size) 以 MAP_SHARED 映射到固定地址 base。
+    // 不会覆盖已有的映射，base 已被占用或映射失败时返回 nullptr。
+    // 映射用 deallocate_aligned 解除。
+    static void* map_file_fixed(int fd, void* base, size_t size);
+
+    // 把 fd 的 [0, size) 以 MAP_SHARED 映射到内核选择的地址，失败时返回 nullptr。
+    // 同一个 fd 在不同进程中的映射地址一般不同
+    static void* map_shared(int fd, size_t size);
+
+    // 创建一个匿名的共享内存文件 (memfd)，大小为 size，失败时返回 -1
+    static int create_shared_file(const char* name, size_t size);
+
+    // 把映射中修改过的页同步写回文件
+    static bool sync_file(void* ptr, size_t size);
+
+    // madvise(MADV_DONTNEED)：把物理页还给操作系统，映射保持不变
+    static bool discard(void* ptr, size_t size);
+
+    // mincore：vec 每页一个字节，最低位为 1 表示该页驻留在物理内存中
+    static bool query_residency(void* ptr, size_t size, unsigned char* vec);
+
 private:
     AlignedMmapper() = delete;
     ~AlignedMmapper() = delete;
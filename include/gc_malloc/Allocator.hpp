@@ -0,0 +1,52 @@
+#ifndef GC_MALLOC_ALLOCATOR_HPP
+#define GC_MALLOC_ALLOCATOR_HPP
+
+#include "gc_malloc/MemoryResource.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+/**
+ * @brief 满足标准库 Allocator 要求的适配器，例如
+ *   std::vector<int, Allocator<int>> v;
+ *
+ * 无状态，所有实例相等。deallocate 把 n * sizeof(T) 作为大小一并传下去。
+ */
+template <typename T>
+class Allocator {
+public:
+    using value_type = T;
+
+    Allocator() noexcept = default;
+
+    template <typename U>
+    Allocator(const Allocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* ptr = ThreadHeapResource::allocate_bytes(n * sizeof(T), alignof(T));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        ThreadHeapResource::deallocate_bytes(ptr, n * sizeof(T), alignof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const Allocator<T>&, const Allocator<U>&) noexcept {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const Allocator<T>&, const Allocator<U>&) noexcept {
+    return false;
+}
+
+#endif // GC_MALLOC_ALLOCATOR_HPP
@@ -0,0 +1,73 @@
+#ifndef GC_MALLOC_ARENA_HPP
+#define GC_MALLOC_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+struct PageGroup;
+
+/**
+ * @brief 用户创建的区域分配器。
+ *
+ * 直接向 CentralHeap 申请 PageGroup，在其中顺序分配（bump pointer）。
+ * 分配出的对象没有 BlockHeader，不进入任何托管链表，也不能单独释放，
+ * 只能通过 reset() 或析构整体归还，代价与持有的 PageGroup 数量成正比，
+ * 与对象数量无关。适合生命周期相同的一批对象，例如一次请求内的临时数据。
+ *
+ * Arena 不是线程安全的，通常由单个线程持有。
+ */
+class Arena {
+public:
+    explicit Arena(size_t chunk_pages = kDefaultChunkPages);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // alignment 必须是 2 的幂。超过一个 Region 的请求返回 nullptr。
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        const uintptr_t p = (cursor_ + alignment - 1) & ~(alignment - 1);
+        // 用 limit_ - p 比较，size 很大时不会回绕；p 为 0 说明还没有 chunk
+        if (__builtin_expect(p >= cursor_ && p <= limit_ && size <= limit_ - p && p != 0, 1)) {
+            cursor_ = p + size;
+            allocated_bytes_ += size;
+            return reinterpret_cast<void*>(p);
+        }
+        return allocate_slow(size, alignment);
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args);
+
+    // 保留第一个 chunk 供下一轮复用，其余 PageGroup 一次性全部归还；
+    // 析构时连同保留的 chunk 一起归还
+    void reset();
+
+    size_t allocated_bytes() const { return allocated_bytes_; }
+    size_t held_pages() const { return held_pages_; }
+
+public:
+    static constexpr size_t kDefaultChunkPages = 16;
+
+private:
+    void* allocate_slow(size_t size, size_t alignment);
+    bool add_chunk(size_t num_pages);
+
+    const size_t chunk_pages_;
+    PageGroup* groups_ = nullptr;       // 通过 next_in_class_list 串起，最新的在表头
+    PageGroup* retained_ = nullptr;     // reset 时保留的第一个常规 chunk
+    uintptr_t cursor_ = 0;
+    uintptr_t limit_ = 0;
+    size_t allocated_bytes_ = 0;
+    size_t held_pages_ = 0;
+};
+
+
+template <typename T, typename... Args>
+T* Arena::create(Args&&... args) {
+    void* mem = allocate(sizeof(T), alignof(T));
+    return mem == nullptr ? nullptr : new (mem) T(static_cast<Args&&>(args)...);
+}
+
+#endif // GC_MALLOC_ARENA_HPP
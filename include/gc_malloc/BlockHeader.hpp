@@ -20,8 +20,24 @@ static_assert(sizeof(BlockHeader) == 24, "BlockHeader size must be 24 bytes on a
 // 定义状态常量
 enum BlockState : uintptr_t {
     STATE_FREED = 0,
-    STATE_IN_USE = 1
+    STATE_IN_USE = 1,
+    STATE_RETIRED = 2,          // 低两位为 2 时，高位保存 retire 时的全局 epoch
+    STATE_IN_USE_OLD = 3        // 已晋升到老年代的块，释放时需要通知所属线程
 };
 
+static constexpr uintptr_t kStateTagMask = 3;
+
+static inline uintptr_t make_retired_state(uint64_t epoch) {
+    return static_cast<uintptr_t>(epoch << 2) | STATE_RETIRED;
+}
+
+static inline bool state_is_retired(uintptr_t state) {
+    return (state & kStateTagMask) == STATE_RETIRED;
+}
+
+static inline uint64_t retired_epoch(uintptr_t state) {
+    return state >> 2;
+}
+
 
 #endif // GC_MALLOC_BLOCK_HEADER_HPP
\ No newline at end of file
@@ -1,25 +1,118 @@
 #ifndef GC_MALLOC_CENTRAL_HEAP_HPP
 #define GC_MALLOC_CENTRAL_HEAP_HPP
 
+#include <atomic>
 #include <mutex>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 #include "gc_malloc/PageGroup.hpp"
 #include "gc_malloc/Bitmap.hpp"
+#include "gc_malloc/HeapConfig.hpp"
+#include "gc_malloc/AlignedMmapper.hpp"
+#include "gc_malloc/MetadataAllocor.hpp"
+#include <assert.h>
+#include <algorithm>
 
-class CentralHeap {
+/**
+ * @brief 页堆：以 Region 为单位向操作系统映射内存，按页分发 PageGroup。
+ *
+ * 页大小与 Region 大小由 Config 在编译期给出（见 HeapConfig.hpp），每种
+ * Config 有自己的单例、空闲链表和锁，可以在同一个进程中并存。从某个
+ * 实例取得的 PageGroup 必须还给同一个实例。
+ *
+ * 模板只覆盖页堆的几何参数。ThreadHeap 与尺寸类别表只支持默认配置，
+ * 即下面的 CentralHeap（见 HeapConfig.hpp 的说明）；它在 CentralHeap.cpp
+ * 中显式实例化，其他配置在使用处隐式实例化。
+ */
+template <typename Config>
+class BasicCentralHeap {
 public:
     // ================== 公共接口 ==================
-    static CentralHeap& GetInstance();
+    static BasicCentralHeap& GetInstance();
     PageGroup* acquire_pages(size_t num_pages);
     void release_pages(PageGroup* group);
 
+    // 把空闲内存还给操作系统：完全空闲的 Region 直接 munmap，其余空闲 span
+    // 除存放头部的第一页外 madvise(MADV_DONTNEED)。返回新归还的字节数，
+    // 之前已经归还、之后没有再分发出去的页不重复计算。
+    size_t release_free_memory();
+
+    // 当前映射的字节数，不加锁
+    size_t mapped_bytes() const { return mapped_bytes_.load(std::memory_order_relaxed); }
+
+    // 映射中没有归还给操作系统的字节数，不加锁，供内存上限检查使用。
+    // 新映射的 Region 中从未分发过的页也算作已归还，因此它近似于页堆
+    // 对 RSS 的贡献，但不需要 mincore
+    size_t committed_bytes() const {
+        // 两个计数分别更新，读到不一致的组合时不能下溢
+        const size_t mapped = mapped_bytes_.load(std::memory_order_relaxed);
+        const size_t purged = purged_bytes_.load(std::memory_order_relaxed);
+        return mapped > purged ? mapped - purged : 0;
+    }
+
+    // 空闲 span 中没有归还给操作系统的字节数，不加锁。包含每个空闲 span
+    // 保存头部的第一页，release_free_memory() 之后也不会降到 0
+    size_t unreleased_free_bytes() const {
+        const size_t committed = committed_bytes();
+        const size_t in_use = pages_in_use_.load(std::memory_order_relaxed) * kPageSize;
+        return committed > in_use ? committed - in_use : 0;
+    }
+
 public:
     // ================== 核心常量 ==================
-    static constexpr size_t kPageSize = 4 * 1024;
-    static constexpr size_t kPagesPerMmap = 256;
+    static constexpr size_t kPageSize = Config::kPageSize;
+    static constexpr size_t kPagesPerMmap = Config::kPagesPerMmap;
     static constexpr size_t kRegionSizeBytes = kPagesPerMmap * kPageSize;
     static constexpr size_t kMaxPages = kPagesPerMmap;
 
+    static_assert(kPageSize % 4096 == 0 && (kPageSize & (kPageSize - 1)) == 0,
+                  "The page size must be a power of two multiple of the system page size.");
+    static_assert(kPagesPerMmap > 0 && (kRegionSizeBytes & (kRegionSizeBytes - 1)) == 0,
+                  "Regions are aligned to their size, which must be a power of two.");
+
+public:
+    // ================== 统计信息 ==================
+    struct Stats {
+        size_t mapped_bytes;                        // 当前向操作系统映射的 Region 总字节数
+        size_t resident_bytes;                      // 其中实际驻留在物理内存中的字节数
+        size_t purged_bytes;                        // 空闲 span 中已归还给操作系统的字节数
+        size_t free_bytes;                          // 空闲 span 的总字节数
+        size_t free_span_count;                     // 空闲 span 的数量
+        size_t free_spans_by_pages[kMaxPages + 1];  // 按页数统计的空闲 span 数量
+        uint64_t regions_mapped;                    // 累计 mmap 的 Region 数量
+        uint64_t regions_unmapped;                  // 累计 munmap 的 Region 数量
+        uint64_t acquire_count;                     // 累计 acquire_pages 成功次数
+        uint64_t release_count;                     // 累计 release_pages 次数
+        uint64_t pages_in_use;                      // 当前分发给上层的页数
+    };
+
+    void collect_stats(Stats* out);
+
+    // ================== 堆快照 ==================
+    // 一个 span：空闲 span 的 group 字段全部为 0。已分发的 PageGroup 的字段
+    // 由持有它的线程并发修改，这里只是持锁期间读到的近似值。
+    struct SpanInfo {
+        uintptr_t start;
+        size_t page_count;
+        bool free;
+        const void* owner_heap;
+        size_t block_size;
+        size_t color_offset;
+        int total_block_count;
+        int block_in_used_count;
+    };
+
+    struct SpanMap {
+        std::vector<uintptr_t> regions;             // 各 Region 的起始地址，升序
+        std::vector<SpanInfo> spans;                // 空闲 span 与已分发的 PageGroup，按地址升序
+        size_t addr_list_spans;                     // 地址链表中的空闲 span 数
+        size_t size_list_spans;                     // 各尺寸链表中的空闲 span 数，两者应当相等
+    };
+
+    // 在锁内遍历地址链表、各尺寸链表与已分发的 PageGroup
+    void collect_span_map(SpanMap* out);
+
 private:
     // ================== 核心数据结构 ==================
     struct FreePageSpan {
@@ -28,6 +121,7 @@ private:
         FreePageSpan* next_in_addr_list;
         FreePageSpan* prev_in_addr_list;
         size_t page_count;
+        size_t purged_pages;        // 已归还给操作系统的页数，不含存放头部的第一页
     };
 
     Bitmap free_list_bitmap_;
@@ -35,19 +129,30 @@ private:
     FreePageSpan free_list_by_addr_;
     std::mutex mutex_;
 
+    // 当前持有的全部 Region 起始地址，仅用于统计与诊断
+    std::vector<void*> regions_;
+    uint64_t regions_mapped_ = 0;
+    uint64_t regions_unmapped_ = 0;
+    uint64_t acquire_count_ = 0;
+    uint64_t release_count_ = 0;
+    std::atomic<uint64_t> pages_in_use_{0};
+    std::atomic<size_t> mapped_bytes_{0};
+    std::atomic<size_t> purged_bytes_{0};      // 所有空闲 span 的 purged_pages 之和
+    PageGroup* acquired_groups_ = nullptr;     // 已分发的 PageGroup，通过 next_acquired 串起
+
 private:
     // ================== 单例模式实现 ==================
-    CentralHeap();
-    ~CentralHeap();
-    CentralHeap(const CentralHeap&) = delete;
-    CentralHeap& operator=(const CentralHeap&) = delete;
+    BasicCentralHeap();
+    ~BasicCentralHeap();
+    BasicCentralHeap(const BasicCentralHeap&) = delete;
+    BasicCentralHeap& operator=(const BasicCentralHeap&) = delete;
 
 private:
     // ================== 私有辅助函数 ==================
     
     // --- 主要的无锁工作流 ---
     void* fetch_from_free_lists_unlocked(size_t num_pages);
-    void reclaim_pages_unlocked(void* start_address, size_t num_pages);
+    void reclaim_pages_unlocked(void* start_address, size_t num_pages, size_t purged_pages = 0);
     
     // --- 获取路径的子程序 ---
     FreePageSpan* find_best_fit_span(size_t num_pages);
@@ -68,4 +173,463 @@ private:
     static bool is_adjacent(const FreePageSpan* span1, const FreePageSpan* span2);
 };
 
-#endif // GC_MALLOC_CENTRAL_HEAP_HPP
\ No newline at end of file
+using CentralHeap = BasicCentralHeap<DefaultHeapConfig>;
+
+extern template class BasicCentralHeap<DefaultHeapConfig>;
+
+
+// =====================================================================
+// 单例模式实现 (Singleton Implementation)
+// =====================================================================
+
+template <typename Config>
+BasicCentralHeap<Config>& BasicCentralHeap<Config>::GetInstance() {
+    static BasicCentralHeap instance;
+    return instance;
+}
+
+
+// =====================================================================
+// 构造与析构 (Constructor & Destructor)
+// =====================================================================
+
+template <typename Config>
+BasicCentralHeap<Config>::BasicCentralHeap()
+    :free_list_bitmap_(kMaxPages + 1)
+{
+    for(size_t i = 0; i <= kMaxPages; i++) {
+        free_lists_by_size_[i].next_in_size_list = &free_lists_by_size_[i];
+        free_lists_by_size_[i].prev_in_size_list = &free_lists_by_size_[i];
+    }
+
+    free_list_by_addr_.next_in_addr_list = &free_list_by_addr_;
+    free_list_by_addr_.prev_in_addr_list = &free_list_by_addr_;
+}
+
+
+template <typename Config>
+BasicCentralHeap<Config>::~BasicCentralHeap() {
+
+}
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+template <typename Config>
+PageGroup* BasicCentralHeap<Config>::acquire_pages(size_t num_pages) {
+    if (num_pages == 0 || num_pages > kMaxPages) {
+        return nullptr;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    void* raw_mem = fetch_from_free_lists_unlocked(num_pages);
+    if (raw_mem == nullptr) {
+        return nullptr;
+    }
+
+    void* pg_mem = MetadataAllocator::GetInstance().allocate(sizeof(PageGroup));
+    if (pg_mem == nullptr) {
+        reclaim_pages_unlocked(raw_mem, num_pages);
+        return nullptr;
+    }
+
+    PageGroup* group = static_cast<PageGroup*>(pg_mem);
+
+    group->start_address = raw_mem;
+    group->page_count = num_pages;
+    group->block_size = 0;
+    group->block_in_used_count = 0;
+    group->sampled_block_count = 0;
+    group->owner_heap = nullptr;
+    group->free_list = nullptr;
+    group->carved_block_count = 0;
+    group->color_offset = 0;
+    group->prev_in_class_list = nullptr;
+    group->next_in_class_list = nullptr;
+
+    group->prev_acquired = nullptr;
+    group->next_acquired = acquired_groups_;
+    if (acquired_groups_ != nullptr) {
+        acquired_groups_->prev_acquired = group;
+    }
+    acquired_groups_ = group;
+
+    acquire_count_++;
+    pages_in_use_.fetch_add(num_pages, std::memory_order_relaxed);
+
+    return group;
+}
+
+
+template <typename Config>
+void BasicCentralHeap<Config>::release_pages(PageGroup* group) {
+    if (group == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (group->prev_acquired != nullptr) {
+        group->prev_acquired->next_acquired = group->next_acquired;
+    } else {
+        acquired_groups_ = group->next_acquired;
+    }
+    if (group->next_acquired != nullptr) {
+        group->next_acquired->prev_acquired = group->prev_acquired;
+    }
+
+    void* start_address = group->start_address;
+    const size_t num_pages = group->page_count;
+    MetadataAllocator::GetInstance().deallocate(group, sizeof(PageGroup));
+
+    release_count_++;
+    pages_in_use_.fetch_sub(num_pages, std::memory_order_relaxed);
+
+    reclaim_pages_unlocked(start_address, num_pages);
+}
+
+
+template <typename Config>
+size_t BasicCentralHeap<Config>::release_free_memory() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t released = 0;
+    FreePageSpan* span = free_list_by_addr_.next_in_addr_list;
+    while (span != &free_list_by_addr_) {
+        FreePageSpan* next = span->next_in_addr_list;
+
+        if (span->page_count == kPagesPerMmap &&
+            reinterpret_cast<uintptr_t>(span) % kRegionSizeBytes == 0) {
+            // 整个 Region 空闲（包括平时为避免反复 mmap 而保留的那一个）
+            remove_from_size_list(span);
+            span->prev_in_addr_list->next_in_addr_list = span->next_in_addr_list;
+            span->next_in_addr_list->prev_in_addr_list = span->prev_in_addr_list;
+            released += kRegionSizeBytes - span->purged_pages * kPageSize;
+            purged_bytes_.fetch_sub(span->purged_pages * kPageSize, std::memory_order_relaxed);
+            munmap_region(span);
+        } else if (span->page_count > 1 && span->purged_pages < span->page_count - 1) {
+            // 第一页保存着 span 头部，必须保留
+            const size_t bytes = (span->page_count - 1) * kPageSize;
+            if (AlignedMmapper::discard(reinterpret_cast<char*>(span) + kPageSize, bytes)) {
+                const size_t newly_purged = span->page_count - 1 - span->purged_pages;
+                span->purged_pages = span->page_count - 1;
+                purged_bytes_.fetch_add(newly_purged * kPageSize, std::memory_order_relaxed);
+                released += newly_purged * kPageSize;
+            }
+        }
+        span = next;
+    }
+    return released;
+}
+
+
+template <typename Config>
+void BasicCentralHeap<Config>::collect_stats(Stats* out) {
+    assert(out != nullptr);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    out->mapped_bytes = regions_.size() * kRegionSizeBytes;
+    out->purged_bytes = purged_bytes_.load(std::memory_order_relaxed);
+    out->free_bytes = 0;
+    out->free_span_count = 0;
+    for (size_t i = 0; i <= kMaxPages; i++) {
+        size_t count = 0;
+        const FreePageSpan* head = &free_lists_by_size_[i];
+        for (const FreePageSpan* span = head->next_in_size_list; span != head; span = span->next_in_size_list) {
+            count++;
+        }
+        out->free_spans_by_pages[i] = count;
+        out->free_span_count += count;
+        out->free_bytes += count * i * kPageSize;
+    }
+
+    // 通过 mincore 逐个 Region 查询驻留页
+    out->resident_bytes = 0;
+    unsigned char residency[kPagesPerMmap];
+    for (void* region : regions_) {
+        if (!AlignedMmapper::query_residency(region, kRegionSizeBytes, residency)) {
+            continue;
+        }
+        for (size_t i = 0; i < kPagesPerMmap; i++) {
+            if (residency[i] & 1) {
+                out->resident_bytes += kPageSize;
+            }
+        }
+    }
+
+    out->regions_mapped = regions_mapped_;
+    out->regions_unmapped = regions_unmapped_;
+    out->acquire_count = acquire_count_;
+    out->release_count = release_count_;
+    out->pages_in_use = pages_in_use_.load(std::memory_order_relaxed);
+}
+
+
+template <typename Config>
+void BasicCentralHeap<Config>::collect_span_map(SpanMap* out) {
+    assert(out != nullptr);
+    out->regions.clear();
+    out->spans.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (void* region : regions_) {
+        out->regions.push_back(reinterpret_cast<uintptr_t>(region));
+    }
+    std::sort(out->regions.begin(), out->regions.end());
+
+    out->addr_list_spans = 0;
+    for (FreePageSpan* span = free_list_by_addr_.next_in_addr_list; span != &free_list_by_addr_;
+         span = span->next_in_addr_list) {
+        out->spans.push_back({reinterpret_cast<uintptr_t>(span), span->page_count, true, nullptr, 0, 0, 0, 0});
+        out->addr_list_spans++;
+    }
+    out->size_list_spans = 0;
+    for (size_t i = 0; i <= kMaxPages; i++) {
+        const FreePageSpan* head = &free_lists_by_size_[i];
+        for (const FreePageSpan* span = head->next_in_size_list; span != head; span = span->next_in_size_list) {
+            out->size_list_spans++;
+        }
+    }
+
+    // 持有线程可能正在修改这些计数，逐个字段原子地读取
+    for (PageGroup* group = acquired_groups_; group != nullptr; group = group->next_acquired) {
+        SpanInfo info;
+        info.start = reinterpret_cast<uintptr_t>(group->start_address);
+        info.page_count = group->page_count;
+        info.free = false;
+        info.owner_heap = __atomic_load_n(&group->owner_heap, __ATOMIC_RELAXED);
+        info.block_size = __atomic_load_n(&group->block_size, __ATOMIC_RELAXED);
+        info.color_offset = __atomic_load_n(&group->color_offset, __ATOMIC_RELAXED);
+        info.total_block_count = __atomic_load_n(&group->total_block_count, __ATOMIC_RELAXED);
+        info.block_in_used_count = __atomic_load_n(&group->block_in_used_count, __ATOMIC_RELAXED);
+        out->spans.push_back(info);
+    }
+
+    std::sort(out->spans.begin(), out->spans.end(),
+              [](const SpanInfo& a, const SpanInfo& b) { return a.start < b.start; });
+}
+
+
+// =====================================================================
+// 私有辅助函数实现 (Private Helper Implementation)
+// =====================================================================
+
+template <typename Config>
+void BasicCentralHeap<Config>::reclaim_pages_unlocked(void* start_address, size_t num_pages, size_t purged_pages) {
+    assert(start_address != nullptr && num_pages > 0 && purged_pages < num_pages);
+
+    // purged_pages 已由调用者计入 purged_bytes_
+    FreePageSpan* new_span = static_cast<FreePageSpan*>(start_address);
+    new_span->page_count = num_pages;
+    new_span->purged_pages = purged_pages;
+
+    FreePageSpan* insertion_point = find_addr_insertion_point(start_address);
+    new_span->next_in_addr_list = insertion_point;
+    new_span->prev_in_addr_list = insertion_point->prev_in_addr_list;
+    insertion_point->prev_in_addr_list->next_in_addr_list = new_span;
+    insertion_point->prev_in_addr_list = new_span;
+
+    FreePageSpan* final_span = try_merge_with_neighbors(new_span);
+    const size_t final_page_count = final_span->page_count;
+
+    if (final_page_count == kPagesPerMmap &&
+        (reinterpret_cast<uintptr_t>(final_span) % (kPagesPerMmap * kPageSize) == 0) &&
+        (free_lists_by_size_[kMaxPages].next_in_size_list != &free_lists_by_size_[kMaxPages]))
+    {
+        final_span->prev_in_addr_list->next_in_addr_list = final_span->next_in_addr_list;
+        final_span->next_in_addr_list->prev_in_addr_list = final_span->prev_in_addr_list;
+
+        purged_bytes_.fetch_sub(final_span->purged_pages * kPageSize, std::memory_order_relaxed);
+        munmap_region(final_span);
+        return;
+    }
+
+    add_to_size_list(final_span);
+}
+
+
+template <typename Config>
+void* BasicCentralHeap<Config>::fetch_from_free_lists_unlocked(size_t num_pages) {
+    assert(num_pages > 0 && num_pages <= kMaxPages);
+
+    while (true) {
+        FreePageSpan* found_span = find_best_fit_span(num_pages);
+        
+        if (found_span != nullptr) {
+            return split_span(found_span, num_pages);
+        }
+        
+        void* new_region = mmap_new_region();
+        if (new_region == nullptr) {
+            return nullptr;
+        }
+        // 新映射的页在第一次写入之前不占物理内存，除头部以外都算作已归还
+        purged_bytes_.fetch_add((kPagesPerMmap - 1) * kPageSize, std::memory_order_relaxed);
+        reclaim_pages_unlocked(new_region, kPagesPerMmap, kPagesPerMmap - 1);
+    }
+    return nullptr;
+}
+
+
+template <typename Config>
+typename BasicCentralHeap<Config>::FreePageSpan* BasicCentralHeap<Config>::try_merge_with_neighbors(FreePageSpan* span) {
+    assert(span != nullptr && span != &free_list_by_addr_);
+    
+    FreePageSpan* prev_span = span->prev_in_addr_list;
+    if (prev_span != &free_list_by_addr_ && is_adjacent(prev_span, span) && is_in_same_region(prev_span, span)) {
+        remove_from_size_list(prev_span);
+
+        span->prev_in_addr_list->next_in_addr_list = span->next_in_addr_list;
+        span->next_in_addr_list->prev_in_addr_list = span->prev_in_addr_list;
+
+        prev_span->page_count += span->page_count;
+        prev_span->purged_pages += span->purged_pages;
+        span = prev_span;
+    }
+
+    FreePageSpan* next_span = span->next_in_addr_list;
+    if (next_span != &free_list_by_addr_ && is_adjacent(span, next_span) && is_in_same_region(span, next_span)) {
+        remove_from_size_list(next_span);
+
+        next_span->prev_in_addr_list->next_in_addr_list = next_span->next_in_addr_list;
+        next_span->next_in_addr_list->prev_in_addr_list = next_span->prev_in_addr_list;
+
+        span->page_count += next_span->page_count;
+        span->purged_pages += next_span->purged_pages;
+    }
+
+    return span;
+}
+
+
+template <typename Config>
+typename BasicCentralHeap<Config>::FreePageSpan* BasicCentralHeap<Config>::find_best_fit_span(size_t num_pages) {
+    size_t index = free_list_bitmap_.FindFirstSet(num_pages);
+
+    if (index > kMaxPages) {
+        return nullptr;
+    }
+
+    FreePageSpan* list_head = &free_lists_by_size_[index];
+    assert(list_head->next_in_size_list != list_head); // 断言链表确实非空
+    FreePageSpan* found_span = list_head->next_in_size_list;
+
+    found_span->prev_in_size_list->next_in_size_list = found_span->next_in_size_list;
+    found_span->next_in_size_list->prev_in_size_list = found_span->prev_in_size_list;
+    
+    found_span->prev_in_addr_list->next_in_addr_list = found_span->next_in_addr_list;
+    found_span->next_in_addr_list->prev_in_addr_list = found_span->prev_in_addr_list;
+
+    if (list_head->next_in_size_list == list_head) {
+        free_list_bitmap_.Clear(index);
+    }
+
+    return found_span;
+}
+
+
+template <typename Config>
+void* BasicCentralHeap<Config>::split_span(FreePageSpan* span, size_t num_pages_to_acquire) {
+    assert(span != nullptr);
+    assert(span->page_count >= num_pages_to_acquire);
+
+    // 分发出去的页都算作占用。整个 span 都已归还时，剩余部分除了新写入
+    // 头部的第一页以外仍是归还状态；否则无法知道归还的页落在哪一部分，
+    // 保守地把剩余部分也算作占用
+    const size_t original_size = span->page_count;
+    const size_t remaining_pages = original_size - num_pages_to_acquire;
+    const size_t remaining_purged =
+        (remaining_pages > 0 && span->purged_pages == original_size - 1) ? remaining_pages - 1 : 0;
+    purged_bytes_.fetch_sub((span->purged_pages - remaining_purged) * kPageSize, std::memory_order_relaxed);
+
+    if (remaining_pages > 0) {
+        char* remaining_start_addr = reinterpret_cast<char*>(span) + num_pages_to_acquire * kPageSize;
+        reclaim_pages_unlocked(remaining_start_addr, remaining_pages, remaining_purged);
+        span->page_count = num_pages_to_acquire;
+    }
+
+    return span;
+}
+
+
+template <typename Config>
+void* BasicCentralHeap<Config>::mmap_new_region() {
+
+    void* new_region = AlignedMmapper::allocate_aligned(kRegionSizeBytes);
+
+    if (new_region == nullptr) {
+        return nullptr;
+    }
+
+    regions_.push_back(new_region);
+    regions_mapped_++;
+    mapped_bytes_.fetch_add(kRegionSizeBytes, std::memory_order_relaxed);
+
+    return new_region;
+}
+
+
+template <typename Config>
+void BasicCentralHeap<Config>::munmap_region(void* region_ptr) {
+    assert(region_ptr != nullptr);
+    assert(reinterpret_cast<uintptr_t>(region_ptr) % kRegionSizeBytes == 0);
+    AlignedMmapper::deallocate_aligned(region_ptr, kRegionSizeBytes);
+
+    regions_.erase(std::remove(regions_.begin(), regions_.end(), region_ptr), regions_.end());
+    regions_unmapped_++;
+    mapped_bytes_.fetch_sub(kRegionSizeBytes, std::memory_order_relaxed);
+}
+
+template <typename Config>
+bool BasicCentralHeap<Config>::is_in_same_region(const void* addr1, const void* addr2) {
+    const uintptr_t region_mask = ~(kRegionSizeBytes - 1);
+    return (reinterpret_cast<uintptr_t>(addr1) & region_mask) == 
+           (reinterpret_cast<uintptr_t>(addr2) & region_mask);
+}
+
+template <typename Config>
+bool BasicCentralHeap<Config>::is_adjacent(const FreePageSpan* span1, const FreePageSpan* span2) {
+    return (reinterpret_cast<const char*>(span1) + span1->page_count * kPageSize) == 
+           reinterpret_cast<const char*>(span2);
+}
+
+template <typename Config>
+void BasicCentralHeap<Config>::remove_from_size_list(FreePageSpan* span) {
+    const size_t original_size = span->page_count;
+    span->prev_in_size_list->next_in_size_list = span->next_in_size_list;
+    span->next_in_size_list->prev_in_size_list = span->prev_in_size_list;
+
+    if (free_lists_by_size_[original_size].next_in_size_list == &free_lists_by_size_[original_size]) {
+        free_list_bitmap_.Clear(original_size);
+    }
+}
+
+template <typename Config>
+void BasicCentralHeap<Config>::add_to_size_list(FreePageSpan* span) {
+    const size_t page_count = span->page_count;
+    assert(page_count > 0 && page_count <= kMaxPages);
+
+    FreePageSpan* list_head = &free_lists_by_size_[page_count];
+    
+    span->next_in_size_list = list_head->next_in_size_list;
+    span->prev_in_size_list = list_head;
+    list_head->next_in_size_list->prev_in_size_list = span;
+    list_head->next_in_size_list = span;
+    
+    free_list_bitmap_.Set(page_count);
+}
+
+template <typename Config>
+typename BasicCentralHeap<Config>::FreePageSpan* BasicCentralHeap<Config>::find_addr_insertion_point(const void* start_address) {
+    FreePageSpan* current = free_list_by_addr_.next_in_addr_list;
+
+    while (current != &free_list_by_addr_ && current < start_address) {
+        current = current->next_in_addr_list;
+    }
+    return current;
+}
+
+#endif // GC_MALLOC_CENTRAL_HEAP_HPP
@@ -0,0 +1,81 @@
+#ifndef GC_MALLOC_CONSERVATIVE_COLLECTOR_HPP
+#define GC_MALLOC_CONSERVATIVE_COLLECTOR_HPP
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class ThreadHeap;
+
+/**
+ * @brief 可选的保守式标记-清除回收。
+ *
+ * collect() 暂停所有持有 ThreadHeap 的线程，以登记的根、各线程的栈
+ * （含挂起时保存的寄存器）为起点，保守地把每个对齐的机器字当作可能的指针
+ * （指向用户空间内任意位置即视为引用），
+ * 递归标记所有托管链表中可达的块；未被标记的块被置为
+ * STATE_FREED，随后由所属线程的 garbage_collect 照常回收。
+ *
+ * 使用约束：
+ *   - 只扫描登记的根和线程栈，不扫描全局变量与 glibc malloc 的内存，
+ *     保存在这些地方的指针需要用 add_root() 登记；
+ *   - 只有调用过 ThreadHeap::GetInstance() 的线程的栈会被扫描；
+ *   - 这些线程不能屏蔽 kSuspendSignal。
+ *
+ * 这是一个线程安全的单例。
+ */
+class ConservativeCollector {
+public:
+    static ConservativeCollector& GetInstance();
+
+    // 安装挂起信号的处理函数，之后 collect() 才会生效
+    void enable();
+    bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+    // 登记/注销一段需要扫描的内存，如保存对象指针的全局数组
+    void add_root(const void* begin, size_t size);
+    void remove_root(const void* begin);
+
+    struct Result {
+        size_t scanned_blocks;      // 参与标记的未释放块数
+        size_t marked_blocks;       // 可达的块数
+        size_t freed_blocks;        // 被置为 STATE_FREED 的块数
+        size_t freed_bytes;         // 按块大小累计
+        uint64_t pause_ns;          // 其他线程被暂停的时长
+    };
+
+    // 执行一次完整的标记-清除，未启用时返回 false
+    bool collect(Result* result = nullptr);
+
+public:
+    static constexpr int kSuspendSignal = SIGPWR;
+
+private:
+    ConservativeCollector() = default;
+    ~ConservativeCollector() = default;
+    ConservativeCollector(const ConservativeCollector&) = delete;
+    ConservativeCollector& operator=(const ConservativeCollector&) = delete;
+
+private:
+    struct Root {
+        const char* begin;
+        const char* end;
+    };
+
+    static void suspend_handler(int sig);
+    void suspend_current_thread();
+
+    std::atomic<bool> enabled_{false};
+    std::mutex collect_mutex_;          // 同一时刻只允许一次回收
+    std::mutex roots_mutex_;
+    std::vector<Root> roots_;
+
+    // 挂起握手：被挂起的线程递增 acks_，然后等待 resume_generation_ 改变
+    std::atomic<size_t> acks_{0};
+    std::atomic<unsigned> resume_generation_{0};
+};
+
+#endif // GC_MALLOC_CONSERVATIVE_COLLECTOR_HPP
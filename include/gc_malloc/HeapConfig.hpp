@@ -0,0 +1,24 @@
+#ifndef GC_MALLOC_HEAP_CONFIG_HPP
+#define GC_MALLOC_HEAP_CONFIG_HPP
+
+#include <cstddef>
+
+// 页堆的几何参数，作为 BasicCentralHeap 的模板参数，全部在编译期确定。
+// 自定义配置只需提供同名的两个常量：
+//   kPageSize      页大小，必须是 4 KiB 的倍数且为 2 的幂
+//   kPagesPerMmap  每个 Region 的页数，Region 大小必须是 2 的幂
+// 一次 acquire_pages 最多取一个 Region。
+//
+// 目前只有页堆的几何参数按配置参数化。ThreadHeap、kNumSizeClasses 与
+// 尺寸类别表仍是全局的，固定使用默认配置，因此其他配置的页堆只能由直接
+// 按页使用内存的代码持有，还不能在默认堆旁边运行一个分配对象的
+// “大 Region、大类别”堆。要做到这一点，需要把 ThreadHeap 与类别表也
+// 做成以 Config 为参数的模板，释放经由 owner_group->owner_heap 分派。
+
+// 默认配置：4 KiB 页，1 MiB Region
+struct DefaultHeapConfig {
+    static constexpr size_t kPageSize = 4 * 1024;
+    static constexpr size_t kPagesPerMmap = 256;
+};
+
+#endif // GC_MALLOC_HEAP_CONFIG_HPP
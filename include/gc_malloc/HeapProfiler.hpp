@@ -0,0 +1,87 @@
+#ifndef GC_MALLOC_HEAP_PROFILER_HPP
+#define GC_MALLOC_HEAP_PROFILER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief 采样式堆分析器。
+ *
+ * 每个线程维护一个“距离下一次采样还剩多少字节”的倒计数，
+ * 平均每分配 sample_period 字节才会有一次分配进入慢路径，
+ * 记录调用栈与请求大小。被采样的块在 garbage_collect 回收时移除。
+ *
+ * 输出为 gperftools 的 heap profile 文本格式 (heap_v2)，
+ * 同时包含在用 (inuse) 与累计 (alloc) 两组数据，可直接交给 pprof。
+ *
+ * 这是一个线程安全的单例。
+ */
+class HeapProfiler {
+public:
+    static HeapProfiler& GetInstance();
+
+    // 设置平均采样间隔（字节），0 表示关闭采样
+    void set_sample_period(size_t bytes);
+    size_t sample_period() const;
+
+    // 供 ThreadHeap 调用：按当前采样间隔抽取下一次采样前需要分配的字节数。
+    // 采样关闭时返回一个较大的复查间隔，使线程能在之后感知到采样被开启。
+    size_t next_sample_distance(uint64_t* rng_state) const;
+
+    void record_allocation(void* ptr, size_t size);
+    // 若 ptr 是一个仍存活的采样块则移除并返回 true
+    bool record_free(void* ptr);
+
+    size_t live_sample_count();
+
+    // 写出 pprof 兼容的 heap profile
+    void write_profile(FILE* out);
+    bool dump_profile(const char* path);
+
+public:
+    static constexpr int kMaxStackDepth = 32;
+    static constexpr size_t kDisabledRecheckBytes = 1024 * 1024;
+
+private:
+    HeapProfiler();
+    ~HeapProfiler() = default;
+    HeapProfiler(const HeapProfiler&) = delete;
+    HeapProfiler& operator=(const HeapProfiler&) = delete;
+
+private:
+    struct StackTrace {
+        int depth;
+        void* frames[kMaxStackDepth];
+
+        bool operator==(const StackTrace& other) const;
+    };
+
+    struct StackTraceHash {
+        size_t operator()(const StackTrace& trace) const;
+    };
+
+    // 同一调用栈的累计数据
+    struct Bucket {
+        uint64_t alloc_count = 0;
+        uint64_t alloc_bytes = 0;
+        uint64_t free_count = 0;
+        uint64_t free_bytes = 0;
+    };
+
+    struct LiveSample {
+        size_t size;
+        Bucket* bucket;
+    };
+
+    std::atomic<size_t> sample_period_{0};
+
+    std::mutex mutex_;
+    std::unordered_map<StackTrace, Bucket, StackTraceHash> buckets_;
+    std::unordered_map<void*, LiveSample> live_samples_;
+};
+
+#endif // GC_MALLOC_HEAP_PROFILER_HPP
@@ -0,0 +1,85 @@
+#ifndef GC_MALLOC_HEAP_SNAPSHOT_HPP
+#define GC_MALLOC_HEAP_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gc_malloc/CentralHeap.hpp"
+#include "gc_malloc/SizeClassInfo.hpp"
+
+// 各尺寸类别的利用率：所有线程中该类别的 PageGroup 汇总
+struct HeapSnapshotClass {
+    size_t block_size;
+    size_t groups;
+    uint64_t in_use_blocks;     // block_in_used_count 之和
+    uint64_t total_blocks;      // total_block_count 之和
+};
+
+// 一个 ThreadHeap 持有的 PageGroup
+struct HeapSnapshotThread {
+    const void* heap;
+    size_t groups;
+    size_t pages;
+    uint64_t in_use_bytes;      // 分配出去的块按块大小累计，含头部
+};
+
+struct HeapSnapshotData {
+    CentralHeap::SpanMap span_map;
+
+    size_t free_spans_by_pages[CentralHeap::kMaxPages + 1];
+    HeapSnapshotClass classes[kNumSizeClasses];
+    std::vector<HeapSnapshotThread> threads;   // 与 ThreadHeap 注册表的顺序相同
+
+    size_t large_groups;            // 正在使用的大对象
+    size_t cached_large_groups;     // 大对象 span 缓存中的
+    size_t other_groups;            // 不属于 ThreadHeap 的，例如 Arena 的 chunk
+    size_t other_pages;
+
+    uint64_t header_bytes;          // 使用中的块的 BlockHeader
+    uint64_t tail_bytes;            // PageGroup 中切不出整块的部分，大对象按页取整的部分
+    uint64_t cached_block_bytes;    // 小对象 PageGroup 中空闲的块
+};
+
+
+/**
+ * @brief 堆快照与碎片图。
+ *
+ * 在 CentralHeap 的锁内遍历地址链表、各尺寸链表、所有 Region 和已分发的
+ * PageGroup，按所属 ThreadHeap 与尺寸类别汇总，输出紧凑的文本报告：
+ * 空闲 span 大小直方图、每个 Region 逐页的占用图、各类别的利用率，
+ * 以及头部与尾部浪费的字节数。
+ *
+ * 不暂停任何线程：PageGroup 的计数由持有线程并发修改，报告中的数值是
+ * 近似值，但 span 的边界和空闲链表是精确的。
+ */
+class HeapSnapshot {
+public:
+    static void capture(HeapSnapshotData* out);
+
+    static void write(FILE* out, const HeapSnapshotData& snapshot);
+    static void print(FILE* out = stderr);
+    static bool dump(const char* path);
+
+    // 收到 signum 时把报告写到 path，用于排查运行中的进程。
+    // 信号处理函数只唤醒一个后台线程，报告在该线程中生成。
+    static bool enable_signal_trigger(int signum, const char* path);
+
+    // 占用图中一页对应的字符
+    static constexpr char kMapFree = '.';
+    static constexpr char kMapLarge = 'L';
+    static constexpr char kMapCachedLarge = 'c';
+    static constexpr char kMapOther = 'o';
+    static constexpr char kMapFull = '#';          // 小对象组中的块全部分配出去；否则为 '0'..'9'，表示占用的十分之几
+    static constexpr char kMapUnknown = '?';
+
+    // 返回每个 Region 一行、每页一个字符的占用图
+    static std::vector<std::string> region_maps(const HeapSnapshotData& snapshot);
+
+private:
+    HeapSnapshot() = delete;
+};
+
+#endif // GC_MALLOC_HEAP_SNAPSHOT_HPP
@@ -0,0 +1,120 @@
+#ifndef GC_MALLOC_HEAP_STATS_HPP
+#define GC_MALLOC_HEAP_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "gc_malloc/SizeClassInfo.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+#include "gc_malloc/atomic_ops.hpp"
+
+/**
+ * @brief 单写者统计计数器。
+ *
+ * 只允许所属线程写入，因此递增无需 lock 前缀的原子指令；
+ * 聚合线程以 relaxed 方式读取，可能读到稍旧的值，但不会读到撕裂的值。
+ */
+struct StatCounter {
+    volatile uintptr_t value = 0;
+
+    void add(uintptr_t n) {
+        atomic_store_relaxed(&value, atomic_load_relaxed(&value) + n);
+    }
+
+    void set_max(uintptr_t n) {
+        if (n > atomic_load_relaxed(&value)) {
+            atomic_store_relaxed(&value, n);
+        }
+    }
+
+    uintptr_t load() const {
+        return atomic_load_relaxed(&value);
+    }
+};
+
+// 每个 ThreadHeap 内嵌一份，由所属线程在分配/回收路径上更新
+struct ThreadHeapCounters {
+    StatCounter alloc_count[kNumSizeClasses];       // 各尺寸类别的分配次数
+    StatCounter free_count[kNumSizeClasses];        // 各尺寸类别被 GC 回收的块数
+    StatCounter refill_count[kNumSizeClasses];      // 各尺寸类别的 refill 次数
+    StatCounter refill_blocks[kNumSizeClasses];     // refill 切分出的块总数
+    StatCounter released_blocks[kNumSizeClasses];   // 随 PageGroup 归还给 CentralHeap 的块总数
+
+    StatCounter large_alloc_count;
+    StatCounter large_free_count;
+    StatCounter large_alloc_bytes;                  // 按页粒度累计
+    StatCounter large_free_bytes;
+    StatCounter large_cache_hits;                   // 直接复用线程内缓存 span 的大对象分配次数
+
+    StatCounter gc_count;                           // garbage_collect 调用次数
+    StatCounter gc_total_ns;                        // garbage_collect 累计耗时
+    StatCounter gc_max_ns;                          // 单次 garbage_collect 最长耗时
+    StatCounter gc_reclaimed_blocks;                // garbage_collect 累计回收的块数（含大对象）
+    StatCounter gc_swept_blocks;                    // 扫描访问过的块数，衡量扫描的实际代价
+    StatCounter gc_promoted_blocks;                 // 晋升到老年代的块数
+    StatCounter gc_old_sweeps;                      // 同时扫描了老年代的次数
+};
+
+
+// =====================================================================
+// 聚合后的统计快照 (Aggregated Snapshot)
+// =====================================================================
+
+struct SizeClassStats {
+    size_t block_size;
+    uint64_t alloc_count;
+    uint64_t free_count;
+    uint64_t refill_count;
+    uint64_t cached_blocks;     // 当前缓存在各线程空闲链表中的块数
+    uint64_t cached_bytes;
+};
+
+struct HeapStatsSnapshot {
+    size_t thread_heap_count;
+
+    SizeClassStats size_classes[kNumSizeClasses];
+
+    uint64_t large_alloc_count;
+    uint64_t large_free_count;
+    uint64_t large_live_bytes;
+    uint64_t large_cache_hits;
+
+    uint64_t gc_count;
+    uint64_t gc_total_ns;
+    uint64_t gc_max_ns;
+    uint64_t gc_reclaimed_blocks;
+    uint64_t gc_swept_blocks;
+    uint64_t gc_promoted_blocks;
+    uint64_t gc_old_sweeps;
+
+    CentralHeap::Stats central;
+
+    size_t metadata_objects;
+    size_t metadata_mapped_bytes;
+};
+
+
+/**
+ * @brief 全局统计接口。
+ *
+ * 统计数据平时分散在各个 ThreadHeap 与 CentralHeap 中，
+ * 只有调用 collect() 时才会遍历并汇总，热路径上没有任何共享写。
+ */
+class HeapStats {
+public:
+    static void collect(HeapStatsSnapshot* out);
+
+    // 类似 glibc malloc_stats() 的人类可读输出
+    static void print(FILE* out = stderr);
+
+    // 机器可读的 JSON 输出
+    static void dump_json(FILE* out);
+    static std::string to_json(const HeapStatsSnapshot& snapshot);
+
+private:
+    HeapStats() = delete;
+};
+
+#endif // GC_MALLOC_HEAP_STATS_HPP
@@ -0,0 +1,102 @@
+#ifndef GC_MALLOC_MEMORY_LIMIT_HPP
+#define GC_MALLOC_MEMORY_LIMIT_HPP
+
+#include "gc_malloc/CentralHeap.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief 进程级的内存上限与压力回收。
+ *
+ * 以 CentralHeap 映射中没有归还给操作系统的字节数（committed_bytes）衡量
+ * 分配器占用的内存，线程缓存、空闲 span 和大对象都包含在内，已 madvise 的
+ * 空闲页不计入，因此与 cgroup memory.max 限制的 RSS 同向变化。占用越过
+ * 软上限时，越线的线程先 trim 自己的缓存，再递增压力代数，其他线程在下一次
+ * 需要新页时发现代数变化，各自 trim 一次；随后把 CentralHeap 的空闲内存
+ * 还给操作系统。回收之后仍接近硬上限（达到硬上限的 kHardLimitRatio）时
+ * 调用用户注册的回调。
+ *
+ * 同一个压力代数也用来请求 trim：线程缓存的总量超过 ThreadHeap 的总预算时，
+ * ThreadHeap 调用 request_trim()，其他线程在下一次进入分配慢路径时各自 trim。
+ *
+ * 为避免存活数据本身超过软上限时每次 refill 都触发回收，每次处理之后
+ * 阈值会提高到当前占用之上一个步长。
+ *
+ * 上限为 0 表示不限制，默认不限制。这是一个线程安全的单例。
+ */
+class MemoryLimit {
+public:
+    static MemoryLimit& GetInstance();
+
+    using HardLimitCallback = void (*)(size_t committed_bytes, size_t hard_limit, void* arg);
+
+    void set_limits(size_t soft_limit, size_t hard_limit);
+    size_t soft_limit() const;
+    size_t hard_limit() const;
+
+    // 读取 cgroup memory.max 格式的文件（一个字节数，或 "max" 表示不限制），
+    // 以其为硬上限、按 soft_ratio 设置软上限。读取失败时返回 false，原有上限不变。
+    bool load_cgroup_limit(const char* path = kDefaultCgroupPath, double soft_ratio = kDefaultSoftRatio);
+
+    void set_hard_limit_callback(HardLimitCallback callback, void* arg);
+
+    // ================== 分配慢路径上的检查 ==================
+    static bool over_threshold() {
+        const size_t threshold = threshold_.load(std::memory_order_relaxed);
+        return threshold != 0 && CentralHeap::GetInstance().committed_bytes() >= threshold;
+    }
+
+    static uint64_t pressure_generation() {
+        return generation_.load(std::memory_order_relaxed);
+    }
+
+    // 由越过阈值的线程在 trim 自己之后调用；已有线程在处理时直接返回
+    void relieve_pressure();
+
+    // 递增压力代数，让所有线程在下一次进入分配慢路径时 trim 一次
+    static void request_trim() {
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    struct Stats {
+        uint64_t soft_events;       // 越过软阈值后执行回收的次数
+        uint64_t hard_events;       // 调用硬上限回调的次数
+        uint64_t released_bytes;    // 累计交还给操作系统的字节数，同一段空闲页只计一次
+    };
+
+    void collect_stats(Stats* out);
+
+public:
+    static constexpr const char* kDefaultCgroupPath = "/sys/fs/cgroup/memory.max";
+    static constexpr double kDefaultSoftRatio = 0.8;
+    static constexpr double kHardLimitRatio = 0.95;
+    static constexpr size_t kMinThresholdStep = 4 * 1024 * 1024;
+
+private:
+    MemoryLimit() = default;
+    ~MemoryLimit() = default;
+    MemoryLimit(const MemoryLimit&) = delete;
+    MemoryLimit& operator=(const MemoryLimit&) = delete;
+
+private:
+    void reset_threshold_locked(size_t committed_bytes);
+
+    // 下一次触发回收的占用，0 表示不检查
+    static std::atomic<size_t> threshold_;
+    static std::atomic<uint64_t> generation_;
+
+    mutable std::mutex mutex_;
+    size_t soft_limit_ = 0;
+    size_t hard_limit_ = 0;
+    HardLimitCallback callback_ = nullptr;
+    void* callback_arg_ = nullptr;
+
+    uint64_t soft_events_ = 0;
+    uint64_t hard_events_ = 0;
+    uint64_t released_bytes_ = 0;
+};
+
+#endif // GC_MALLOC_MEMORY_LIMIT_HPP
@@ -0,0 +1,41 @@
+#ifndef GC_MALLOC_MEMORY_RESOURCE_HPP
+#define GC_MALLOC_MEMORY_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * @brief 以 ThreadHeap 为后端的 std::pmr::memory_resource。
+ *
+ * 内存从调用线程的 ThreadHeap 分配；释放只是把块标记为已释放，
+ * 真正的回收仍发生在所属线程的 garbage_collect 中。释放时容器给出的
+ * 大小原样传给 ThreadHeap::deallocate(ptr, size)。
+ *
+ * 块的用户空间按 kNaturalAlignment 对齐。更高的对齐要求通过多分配
+ * alignment 字节实现，原始指针保存在返回地址之前的一个字中。
+ *
+ * BlockHeader 占 24 字节，用户空间只保证 8 字节对齐，而
+ * memory_resource::allocate(n) 的默认对齐是 alignof(max_align_t)（16），
+ * 所以不指定对齐的 pmr 调用也会走多分配的路径，每次多占 16 字节。
+ * 元素对齐不超过 8 的 Allocator<T> 不受影响。
+ *
+ * 所有实例都使用同一组 ThreadHeap，因此任意两个实例都相等。
+ */
+class ThreadHeapResource : public std::pmr::memory_resource {
+public:
+    static ThreadHeapResource* GetInstance();
+
+    // 供 Allocator<T> 直接调用，失败时返回 nullptr
+    static void* allocate_bytes(size_t bytes, size_t alignment);
+    static void deallocate_bytes(void* ptr, size_t bytes, size_t alignment);
+
+public:
+    static constexpr size_t kNaturalAlignment = 8;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+#endif // GC_MALLOC_MEMORY_RESOURCE_HPP
@@ -16,6 +16,11 @@ public:
     void* allocate(size_t size);
 
     void deallocate(void* ptr, size_t size);
+
+    // 统计接口：当前已分配出去的元数据对象数量，以及累计申请的 Chunk 数量
+    size_t allocated_objects_count();
+    size_t chunks_acquired();
+    size_t chunk_size() const { return kChunkSize; }
     
 private:
 
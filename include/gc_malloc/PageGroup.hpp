@@ -3,6 +3,9 @@
 
 #include <cstddef>
 
+struct BlockHeader;
+class ThreadHeap;
+
 struct PageGroup
 {
     void* start_address;        // 该结构所描述的内存起始地址
@@ -10,6 +13,19 @@ struct PageGroup
     size_t block_size;          // 内存要切分出的块大小
     int total_block_count;      // 切分出的总体的块数量
     int block_in_used_count;    // 分配出去的块数量
+    int sampled_block_count;    // 被堆采样器记录、尚未回收的块数量
+    ThreadHeap* owner_heap;     // 持有该 PageGroup 的 ThreadHeap，释放老年代块时据此计数
+
+    // 以下字段只由持有该 PageGroup 的 ThreadHeap 使用
+    BlockHeader* free_list;             // 组内已切分过、当前空闲的块
+    int carved_block_count;             // 已从组首切分出的块数，之后的内存尚未被访问
+    size_t color_offset;                // 第一个块相对 start_address 的偏移，缓存行的整数倍
+    PageGroup* prev_in_class_list;      // 所在的 partial/empty 链表
+    PageGroup* next_in_class_list;
+
+    // 以下字段只由 CentralHeap 在持锁时使用：所有已分发的 PageGroup 组成的链表，供堆快照遍历
+    PageGroup* prev_acquired;
+    PageGroup* next_acquired;
 };
 
 
@@ -0,0 +1,86 @@
+#ifndef GC_MALLOC_PERSISTENT_HEAP_HPP
+#define GC_MALLOC_PERSISTENT_HEAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include "gc_malloc/SegmentHeap.hpp"
+
+/**
+ * @brief 映射自文件的持久化堆，用于进程重启后快速恢复内存中的数据。
+ *
+ * 整个堆是一个以 MAP_SHARED 映射到固定地址的文件，分配器的全部元数据
+ * （文件头、空闲页段、各尺寸类别的空闲链表）都保存在文件内部，页堆部分
+ * 由 SegmentHeap 实现。基址固定，对象之间可以直接保存普通指针。重新打开时只需把文件映射回同一地址，不需要任何
+ * 反序列化；应用通过根指针 (set_root/root) 找回自己的数据。
+ *
+ * 与 ThreadHeap 不同，这里的块由调用者显式释放，不参与 GC。
+ * 打开期间文件头记录为 dirty，close() 同步后清除；进程崩溃后重新打开时
+ * was_clean() 返回 false，此时最后一次 sync() 之后的修改可能只写回了一部分。
+ *
+ * 一个文件同一时刻只能被一个 PersistentHeap 打开。该类是线程安全的。
+ */
+class PersistentHeap {
+public:
+    PersistentHeap() = default;
+    ~PersistentHeap();
+
+    PersistentHeap(const PersistentHeap&) = delete;
+    PersistentHeap& operator=(const PersistentHeap&) = delete;
+
+    // 打开 path，文件不存在或为空时按 size 字节创建并映射到 base。
+    // 已有的文件沿用其中记录的基址和大小，忽略这两个参数。
+    // 基址已被占用、文件格式不符或系统调用失败时返回 false。
+    bool open(const char* path, size_t size, uintptr_t base = kDefaultBase);
+
+    // 同步全部修改、标记为正常关闭并解除映射
+    void close();
+
+    bool is_open() const { return header_ != nullptr; }
+    bool was_created() const { return created_; }
+    bool was_clean() const { return was_clean_; }
+
+    void* base() const { return header_; }
+    size_t size() const;
+
+    // 空间不足时返回 nullptr。返回的地址按 16 字节对齐
+    void* allocate(size_t size);
+    void deallocate(void* ptr);
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args);
+
+    // 根指针：保存在文件头中，重新打开后按槽位取回
+    void set_root(size_t slot, void* ptr);
+    void* root(size_t slot) const;
+
+    // 把修改写回文件，返回是否成功
+    bool sync();
+
+public:
+    static constexpr uintptr_t kDefaultBase = 0x200000000000;   // 远离 mmap 与栈的默认区域
+    static constexpr size_t kMaxRoots = 16;
+    static constexpr size_t kPageSize = SegmentHeap::kPageSize;
+
+private:
+    struct Header;
+
+    Header* header_ = nullptr;
+    SegmentHeap segment_;
+    int fd_ = -1;
+    bool created_ = false;
+    bool was_clean_ = false;
+    mutable std::mutex mutex_;
+};
+
+
+template <typename T, typename... Args>
+T* PersistentHeap::create(Args&&... args) {
+    static_assert(alignof(T) <= 16, "PersistentHeap only guarantees 16-byte alignment.");
+    void* mem = allocate(sizeof(T));
+    return mem == nullptr ? nullptr : new (mem) T(static_cast<Args&&>(args)...);
+}
+
+#endif // GC_MALLOC_PERSISTENT_HEAP_HPP
@@ -0,0 +1,63 @@
+#ifndef GC_MALLOC_SEGMENT_HEAP_HPP
+#define GC_MALLOC_SEGMENT_HEAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gc_malloc/SizeClassInfo.hpp"
+
+/**
+ * @brief 映射段内的页堆：空闲页段加上各尺寸类别的空闲链表。
+ *
+ * PersistentHeap 与 SharedHeap 共用这部分实现。全部状态都保存在段内，
+ * 引用是相对段首的偏移，0 表示空，因此段可以映射到任意地址。小对象按
+ * 尺寸类别从整页切分，释放后挂回类别的空闲链表；超过最大类别的请求整页
+ * 分配，释放的页段按偏移合并，紧邻 top 的页段直接退回到 top。
+ *
+ * 本类不加锁，由使用者在自己的锁内调用。每次修改都先写好尚未链入的
+ * 内存，再用一次对齐的存储发布，持锁者在任意位置中断只会泄漏那一次
+ * 涉及的页，不会留下互相重叠的页段。
+ */
+class SegmentHeap {
+public:
+    static constexpr size_t kPageSize = 4096;
+
+    // 保存在使用者段头中的状态
+    struct State {
+        size_t size;                        // 段的总字节数
+        size_t top;                         // 从未分配过的第一页的偏移
+        size_t free_runs;                   // 空闲页段，按偏移升序
+        size_t class_free[kNumSizeClasses];
+    };
+
+    SegmentHeap() = default;
+    SegmentHeap(void* base, State* state) : base_(static_cast<char*>(base)), state_(state) {}
+
+    // 初始化新段的状态。段的其余内容必须全部为 0，前 header_bytes 字节留给段头
+    static void initialize(State* state, size_t size, size_t header_bytes);
+
+    // 返回块中用户内存的偏移，按 16 字节对齐；空间不足时返回 0
+    size_t allocate(size_t size);
+
+    // offset 为 allocate 返回的偏移
+    void deallocate(size_t offset);
+
+    // 段头大小或尺寸类别表改变后，旧段中的空闲链表不再有效，打开时据此拒绝
+    static uint64_t layout_fingerprint(size_t header_size);
+
+private:
+    struct FreeRun;
+    struct Block;
+
+    template <typename T>
+    T* at(size_t offset) const { return reinterpret_cast<T*>(base_ + offset); }
+
+    size_t allocate_pages(size_t num_pages);
+    void release_pages(size_t offset, size_t num_pages);
+    bool refill_class(size_t index);
+
+    char* base_ = nullptr;
+    State* state_ = nullptr;
+};
+
+#endif // GC_MALLOC_SEGMENT_HEAP_HPP
@@ -0,0 +1,96 @@
+#ifndef GC_MALLOC_SHARED_HEAP_HPP
+#define GC_MALLOC_SHARED_HEAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "gc_malloc/SegmentHeap.hpp"
+
+/**
+ * @brief 多个进程共同映射的共享内存堆，用于同机进程间零拷贝传递消息。
+ *
+ * 内存来自一个 memfd 共享内存段，由 create() 的进程创建，其他进程通过
+ * fork 继承或 SCM_RIGHTS 传递得到 fd 后 attach()。各进程的映射地址不同，
+ * 因此段内的全部元数据（空闲页段、尺寸类别空闲链表、根）都用相对段首的
+ * 偏移表示。页堆由 SegmentHeap 实现，由段内一把进程间共享的 robust
+ * 互斥锁保护。
+ *
+ * 对象在任意进程中分配，把 to_offset() 的结果发给对端，对端用
+ * from_offset() 得到自己地址空间中的指针，用完后可以直接在对端释放。
+ * 对象内部如果还要保存指向段内其他对象的引用，也必须保存偏移。
+ *
+ * 持锁的进程崩溃后，其他进程仍能取得锁继续使用。SegmentHeap 的每次修改
+ * 都由最后一次存储发布，那一次未完成的分配或释放最多泄漏其涉及的页或块，
+ * 不会留下互相重叠的页段。
+ *
+ * 每个进程内的 SharedHeap 对象是线程安全的。
+ */
+class SharedHeap {
+public:
+    SharedHeap() = default;
+    ~SharedHeap();
+
+    SharedHeap(const SharedHeap&) = delete;
+    SharedHeap& operator=(const SharedHeap&) = delete;
+
+    // 创建一个 size 字节（按页取整）的新共享内存段并映射
+    bool create(size_t size, const char* name = "gc_malloc_shared");
+
+    // 映射其他进程创建的段。fd 会被复制，调用者可以随后关闭自己的 fd
+    bool attach(int fd);
+
+    // 解除映射。段在所有进程都解除映射并关闭 fd 之后才会被释放
+    void detach();
+
+    bool is_open() const { return header_ != nullptr; }
+    int fd() const { return fd_; }
+    void* base() const { return header_; }
+    size_t size() const;
+
+    // 空间不足时返回 nullptr。返回的地址按 16 字节对齐
+    void* allocate(size_t size);
+
+    // ptr 可以来自任意进程分配的对象在本进程中的地址
+    void deallocate(void* ptr);
+
+    template <typename T, typename... Args>
+    T* create_object(Args&&... args);
+
+    // 指针与段内偏移的相互转换。nullptr 对应偏移 0，段首的文件头不会被分配出去
+    size_t to_offset(const void* ptr) const {
+        return ptr == nullptr ? 0 : static_cast<size_t>(static_cast<const char*>(ptr) - reinterpret_cast<const char*>(header_));
+    }
+    void* from_offset(size_t offset) const {
+        return offset == 0 ? nullptr : reinterpret_cast<char*>(header_) + offset;
+    }
+
+    // 根：保存在段头中的偏移，供各进程约定位置找到共享的数据结构
+    void set_root(size_t slot, void* ptr);
+    void* root(size_t slot) const;
+
+public:
+    static constexpr size_t kMaxRoots = 16;
+    static constexpr size_t kPageSize = SegmentHeap::kPageSize;
+
+private:
+    struct Header;
+
+    bool map(int fd, bool initialize);
+    void lock() const;
+    void unlock() const;
+
+    Header* header_ = nullptr;
+    SegmentHeap segment_;
+    int fd_ = -1;
+};
+
+
+template <typename T, typename... Args>
+T* SharedHeap::create_object(Args&&... args) {
+    static_assert(alignof(T) <= 16, "SharedHeap only guarantees 16-byte alignment.");
+    void* mem = allocate(sizeof(T));
+    return mem == nullptr ? nullptr : new (mem) T(static_cast<Args&&>(args)...);
+}
+
+#endif // GC_MALLOC_SHARED_HEAP_HPP
@@ -0,0 +1,54 @@
+#ifndef GC_MALLOC_SIZE_CLASS_GENERATOR_HPP
+#define GC_MALLOC_SIZE_CLASS_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "gc_malloc/SizeHistogram.hpp"
+
+struct GeneratedSizeClass {
+    size_t block_size;          // 包含 BlockHeader
+    size_t pages_to_acquire;
+};
+
+struct SizeClassGeneratorOptions {
+    size_t num_classes = 17;            // 最多生成的类别数
+    size_t max_block_size = 16384;      // 最大类别的块大小，始终会被覆盖
+    size_t alignment = 16;              // 块大小必须是它的倍数
+    size_t min_blocks_per_group = 8;    // 每次 refill 至少切出的块数
+    size_t max_pages = 32;              // 每次 refill 最多申请的页数
+};
+
+/**
+ * @brief 根据请求大小直方图离线生成尺寸类别表。
+ *
+ * 代价函数为“每次分配的期望浪费字节数”：块内浪费（块大小减去请求
+ * 大小与 BlockHeader）加上 PageGroup 尾部无法切出整块的部分按块数均摊。
+ * 在候选块大小上做动态规划，求出不超过 num_classes 个类别的最优划分，
+ * 每个类别再独立挑选 refill 页数。
+ */
+class SizeClassGenerator {
+public:
+    // 失败（参数非法）时返回 false
+    static bool generate(const std::vector<SizeHistogramEntry>& histogram,
+                         const SizeClassGeneratorOptions& options,
+                         std::vector<GeneratedSizeClass>* out);
+
+    // 为给定块大小挑选 refill 页数：满足最少块数的前提下尾部浪费最小，
+    // 浪费相近时取页数较少者
+    static size_t choose_pages(size_t block_size, const SizeClassGeneratorOptions& options);
+
+    // 按上面的代价函数计算每次小对象分配的平均浪费字节数，
+    // 超出最大类别的请求走大对象路径，不计入
+    static double expected_waste(const std::vector<SizeHistogramEntry>& histogram,
+                                 const std::vector<GeneratedSizeClass>& classes);
+
+    // 当前编译进库中的尺寸类别表
+    static void current_classes(std::vector<GeneratedSizeClass>* out);
+
+    // 输出与 SizeClassTable.def 相同格式的表
+    static void write_table(FILE* out, const std::vector<GeneratedSizeClass>& classes);
+};
+
+#endif // GC_MALLOC_SIZE_CLASS_GENERATOR_HPP
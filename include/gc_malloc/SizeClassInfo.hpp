@@ -2,16 +2,111 @@
 #define GC_MALLOC_SIZE_CLASS_INFO_HPP
 
 #include <cstddef>
+#include <cstdint>
 
+// 尺寸类别表以 X-macro 的形式定义，默认使用 SizeClassTable.def，
+// 也可以在编译时通过 GC_MALLOC_SIZE_CLASS_TABLE 指定生成的表文件。
+// 定义 GC_MALLOC_CACHE_ALIGNED_BLOCKS 时默认改用缓存行对齐的表。
+#ifndef GC_MALLOC_SIZE_CLASS_TABLE
+#ifdef GC_MALLOC_CACHE_ALIGNED_BLOCKS
+#define GC_MALLOC_SIZE_CLASS_TABLE "gc_malloc/SizeClassTableCacheAligned.def"
+#else
+#define GC_MALLOC_SIZE_CLASS_TABLE "gc_malloc/SizeClassTable.def"
+#endif
+#endif
 
-static constexpr size_t kNumSizeClasses = 17;
+static constexpr size_t kCacheLineSize = 64;
+
+static constexpr size_t kNumSizeClasses = 0
+#define SIZE_CLASS(block_size, pages_to_acquire) + 1
+#include GC_MALLOC_SIZE_CLASS_TABLE
+#undef SIZE_CLASS
+;
+
+static_assert(kNumSizeClasses > 0, "The size class table must not be empty.");
+
+// 编译期可见的块大小，供 TypedPool 等在编译期确定尺寸类别
+static constexpr size_t kSizeClassBlockSizes[kNumSizeClasses] = {
+#define SIZE_CLASS(block_size, pages_to_acquire) block_size,
+#include GC_MALLOC_SIZE_CLASS_TABLE
+#undef SIZE_CLASS
+};
+
+#ifdef GC_MALLOC_CACHE_ALIGNED_BLOCKS
+static constexpr bool all_size_classes_cache_aligned() {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        if (kSizeClassBlockSizes[i] % kCacheLineSize != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(all_size_classes_cache_aligned(),
+              "GC_MALLOC_CACHE_ALIGNED_BLOCKS requires every block size to be a multiple of the cache line size.");
+#endif
+
+static constexpr bool all_size_classes_lookup_aligned() {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        if (kSizeClassBlockSizes[i] % 16 != 0 || (i > 0 && kSizeClassBlockSizes[i] <= kSizeClassBlockSizes[i - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(all_size_classes_lookup_aligned(),
+              "Block sizes must be strictly increasing multiples of 16.");
+static_assert(kNumSizeClasses < 256, "Class indices are stored in a byte-wide lookup table.");
+
+// 小尺寸按 16 字节一格直接查表得到类别，更大的尺寸在其余类别上二分查找
+struct SizeClassLookup {
+    static constexpr size_t kGranularityShift = 4;
+    static constexpr size_t kMaxSize = 16384;
+    static constexpr size_t kEntries = (kMaxSize >> kGranularityShift) + 1;
+
+    uint8_t index[kEntries];
+
+    constexpr SizeClassLookup() : index{} {
+        size_t c = 0;
+        for (size_t i = 0; i < kEntries; ++i) {
+            while (c < kNumSizeClasses && kSizeClassBlockSizes[c] < (i << kGranularityShift)) {
+                ++c;
+            }
+            index[i] = static_cast<uint8_t>(c);
+        }
+    }
+};
+
+inline constexpr SizeClassLookup kSizeClassLookup{};
 
 class SizeClassInfo {
 public:
-    static size_t map_size_to_index(size_t size);
+    // size 为块大小，即用户请求大小加上 BlockHeader。编译期也可以使用
+    static constexpr size_t map_size_to_index(size_t size) {
+        if (size <= SizeClassLookup::kMaxSize) {
+            return kSizeClassLookup.index[(size + (1 << SizeClassLookup::kGranularityShift) - 1) >>
+                                          SizeClassLookup::kGranularityShift];
+        }
+        size_t lo = kSizeClassLookup.index[SizeClassLookup::kEntries - 1];
+        size_t hi = kNumSizeClasses;
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (kSizeClassBlockSizes[mid] < size) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
     static size_t get_block_size_for_index(size_t index);
     static size_t get_pages_to_acquire_for_index(size_t index);
+
+    // map_size_to_index 的别名，供需要在编译期确定类别的代码使用
+    static constexpr size_t constexpr_index_for(size_t size) {
+        return map_size_to_index(size);
+    }
 };
 
 
-#endif // GC_MALLOC_SIZE_CLASS_INFO_HPP
\ No newline at end of file
+#endif // GC_MALLOC_SIZE_CLASS_INFO_HPP
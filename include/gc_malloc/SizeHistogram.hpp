@@ -0,0 +1,67 @@
+#ifndef GC_MALLOC_SIZE_HISTOGRAM_HPP
+#define GC_MALLOC_SIZE_HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+struct SizeHistogramEntry {
+    size_t size;        // 桶内最大的请求大小
+    uint64_t count;
+};
+
+/**
+ * @brief 运行时请求大小直方图，作为尺寸类别生成器的输入。
+ *
+ * 默认关闭，关闭时分配路径上只有一次 relaxed 读。开启后每个线程
+ * 写入自己的计数数组，collect()/dump() 时再汇总，因此可以在
+ * 进程运行中随时开启、导出。
+ *
+ * 分桶方式：1 KiB 以内按 8 字节对齐；1 KiB 到 1 MiB 之间每个
+ * 2 的幂区间再均分为 16 份；更大的请求归入最后一个溢出桶。
+ */
+class SizeHistogram {
+public:
+    static bool enabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    static void enable();
+    static void disable();
+    static void reset();
+
+    static void record(size_t size);
+
+    // 汇总所有线程的非零桶，按 size 递增排列
+    static void collect(std::vector<SizeHistogramEntry>* out);
+
+    // 文本格式：以 '#' 开头的注释行，之后每行 "<size> <count>"
+    static void dump(FILE* out);
+    static bool read(FILE* in, std::vector<SizeHistogramEntry>* out);
+
+    static size_t bucket_index(size_t size);
+    static size_t bucket_upper_bound(size_t index);
+
+public:
+    static constexpr size_t kLinearLimit = 1024;
+    static constexpr size_t kLinearStep = 8;
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kMaxTrackedSize = 1024 * 1024;
+    static constexpr size_t kNumLinearBuckets = kLinearLimit / kLinearStep;
+    static constexpr size_t kNumBuckets = kNumLinearBuckets + (20 - 10) * (1 << kSubBucketBits) + 1;
+
+private:
+    SizeHistogram() = delete;
+
+    struct ThreadHistogram;
+    static ThreadHistogram* get_thread_histogram();
+
+    static std::atomic<bool> enabled_;
+    static std::mutex registry_mutex_;
+    static ThreadHistogram* registry_head_;
+};
+
+#endif // GC_MALLOC_SIZE_HISTOGRAM_HPP
@@ -5,6 +5,11 @@
 #include "gc_malloc/SizeClassInfo.hpp"
 #include "gc_malloc/BlockHeader.hpp"
 #include "gc_malloc/atomic_ops.hpp"
+#include "gc_malloc/HeapStats.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <pthread.h>
 
 class PageGroup;
 
@@ -14,9 +19,91 @@ public:
     static ThreadHeap* GetInstance();
     static void deallocate(void* ptr);
 
+    // 带大小的释放，size 为分配时请求的大小。块头已经记录了所属 PageGroup，
+    // 大小只用于调试构建下的一致性检查
+    static void deallocate(void* ptr, size_t size);
+
     void* allocate(size_t size);
     void garbage_collect();
 
+    // 从指定尺寸类别一次取出最多 count 个块，返回实际数量。块与 allocate
+    // 返回的块完全相同，但不经过尺寸映射、采样和直方图，供 TypedPool 批量补充。
+    // trace 开启时按块的可用大小记录分配。
+    size_t allocate_batch(size_t index, void** out, size_t count);
+
+    // ================== 基于 epoch 的延迟回收 ==================
+    // 供无锁数据结构使用：从结构中摘下的块用 retire 代替 deallocate，
+    // 所有在 retire 之前进入临界区的线程都退出之后，garbage_collect 才会回收它。
+    // 读者只需用 enter_critical/exit_critical（或 EpochGuard）包住访问，
+    // 进入时一次写和一次 fence，访问每个指针时不需要任何额外同步。
+    static void retire(void* ptr);
+
+    // 可以嵌套，只有最外层的调用生效
+    void enter_critical() {
+        if (critical_depth_++ == 0) {
+            active_epoch_.store(global_epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            // 保证之后对共享数据的读取不会被重排到公布 epoch 之前
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void exit_critical() {
+        if (--critical_depth_ == 0) {
+            active_epoch_.store(0, std::memory_order_release);
+        }
+    }
+
+    static uint64_t current_epoch() { return global_epoch_.load(std::memory_order_acquire); }
+
+    // ================== 缓存容量控制 ==================
+    // 回收已释放的块，并把所有完全空闲的 PageGroup 归还给 CentralHeap；
+    // CentralHeap 中未归还的空闲页超过 kFreePagesReleaseBytes 时再还给操作系统。
+    // 线程退出时会自动调用一次。
+    void trim();
+
+    // 当前缓存的字节数：各类别空闲链表中的块加上大对象 span 缓存，
+    // 两者合计受 thread_cache_budget() 限制
+    size_t cached_bytes() const;
+
+    // 大对象 span 缓存中的字节数
+    size_t large_cached_bytes() const { return large_cache_bytes_; }
+
+    // 每个线程可缓存字节数的上限：总预算按活跃线程数均分，但不低于下限
+    static size_t thread_cache_budget();
+
+    // 所有线程最近一次公布的缓存字节数之和。线程在扫描、trim 和慢路径上的
+    // 衰减之后公布；超过 kOverallCacheBytes 时通过 MemoryLimit::request_trim()
+    // 让其他线程在下一次进入分配慢路径时 trim。从不分配也从不 GC 的线程无法
+    // 被其他线程回收，它的缓存保持在上次公布时的预算之内，直到线程退出。
+    static size_t total_cached_bytes() { return total_cached_bytes_.load(std::memory_order_relaxed); }
+
+    // ================== 统计与遍历 ==================
+    const ThreadHeapCounters& counters() const { return counters_; }
+
+    // 在注册表锁保护下依次访问所有已创建的 ThreadHeap。
+    // ThreadHeap 在线程退出后不会被销毁，因此遍历期间实例始终有效。
+    template <typename Fn>
+    static void for_each_instance(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (ThreadHeap* heap = registry_head_; heap != nullptr; heap = heap->next_in_registry_) {
+            fn(*heap);
+        }
+    }
+
+public:
+    static constexpr size_t kOverallCacheBytes = 32 * 1024 * 1024;   // 所有线程缓存的总预算
+    static constexpr size_t kMinThreadCacheBytes = 128 * 1024;      // 单个线程预算的下限
+    static constexpr size_t kMaxClassCacheBytes = 1024 * 1024;      // 单个类别上限的增长上界
+    static constexpr size_t kOccupancyBuckets = 8;                  // partial PageGroup 按占用率分桶的数量
+    static constexpr int kMaxOverages = 3;                          // 连续超限多少次后收缩上限
+    static constexpr uint64_t kDecayIntervalNs = 1000 * 1000 * 1000; // 空闲衰减的周期
+    static constexpr size_t kPromotionAge = 2;                      // 块在年轻代中存活多少次扫描后晋升
+    static constexpr size_t kOldGarbageRatio = 8;                   // 老年代中被释放的块达到 1/N 时扫描老年代
+    static constexpr uint32_t kOldSweepInterval = 64;               // 最多隔多少次扫描必须扫描一次老年代
+    static constexpr size_t kLargeCacheBytes = 2 * 1024 * 1024;     // 每个线程缓存的大对象 span 总字节数上限，另受线程预算限制
+    static constexpr size_t kLargeCacheSlack = 8;                   // 复用的 span 最多比需要的多 1/N 页
+    static constexpr size_t kFreePagesReleaseBytes = 8 * 1024 * 1024; // CentralHeap 中未归还的空闲页超过该值时在衰减与 trim 时归还
+
 private:
     ThreadHeap() = default;
     ~ThreadHeap();
@@ -25,20 +112,132 @@ private:
     ThreadHeap& operator=(const ThreadHeap&) = delete;
 
 private:
+    BlockHeader* take_block(size_t index);
+    void link_managed(BlockHeader* block);
+    void sweep(bool include_old);
+    bool should_sweep_old() const;
+    BlockHeader* sweep_list(BlockHeader*& head, bool promote, size_t* visited, size_t* reclaimed, size_t* retired);
+    bool retired_block_is_safe(uintptr_t state);
+    static uint64_t try_advance_epoch();
+    void reclaim_block(BlockHeader* block);
+    PageGroup* take_cached_span(size_t num_pages);
+    void cache_large_span(PageGroup* group);
+    void release_large_cache(size_t target_bytes);
+    void splice_list(BlockHeader*& from, BlockHeader* tail, BlockHeader*& to);
     bool refill(size_t index);
+    void sample_allocation(BlockHeader* block, size_t size);
     PageGroup* request_pages_from_central_heap(size_t num_pages);
     void release_pages_to_central_heap(PageGroup* group);
 
+    size_t release_empty_groups(size_t index, size_t target_count);
+    void recycle_block(size_t index, BlockHeader* block);
+    PageGroup* select_group(size_t index);
+    void retire_current_groups();
+    void enforce_cache_limits();
+    void decay_idle_cache(uint64_t now_ns);
+    void on_allocation_slow_path();
+    void publish_cached_bytes();
+    void on_thread_exit();
+    bool memory_pressure_pending() const;
+    void relieve_memory_pressure();
+    friend struct ThreadHeapExitGuard;
+    friend class ConservativeCollector;
+
 private:
-    struct FreeList {
-        BlockHeader* head = nullptr;
+    // 空闲块挂在各自 PageGroup 的 free_list 上（新组尚未切分的尾部按需切分），
+    // 每个类别只维护 PageGroup：
+    //   current 正在分配的组，不在任何链表中，分配快路径只访问它；
+    //   partial 部分块已分配的组，按 block_in_used_count / total_block_count 分桶，
+    //           current 用完后总是从占用率最高的非空桶中选下一个组，
+    //           使几乎空闲的组得不到新分配、尽快变空并被归还；
+    //   empty   所有块都空闲的组，可以 O(1) 摘下归还给 CentralHeap。
+    // 块全部分配出去的组不在任何链表中，直到 GC 回收了它的块。
+    //
+    // count 是所有组的空闲块总数。max_count 随需求自适应：refill 时说明缓存
+    // 不够用，增加一个 PageGroup 的量；连续多次超限说明缓存偏大，减少一个
+    // PageGroup 的量。low_water 是上次衰减以来 count 的最小值，这部分块在整个
+    // 周期内都没有被用到。
+    struct ClassCache {
+        PageGroup* current = nullptr;
+        PageGroup* partial[kOccupancyBuckets] = {};
+        uint32_t partial_mask = 0;      // 第 i 位表示 partial[i] 非空
+        PageGroup* empty = nullptr;
         size_t count = 0;
+        size_t max_count = 0;
+        size_t low_water = 0;
+        int overages = 0;
+        unsigned next_color = 0;        // 下一个新组使用的着色序号
     };
 
     static thread_local ThreadHeap* tls_instance_;
 
-    FreeList free_lists_[kNumSizeClasses];
-    BlockHeader* managed_list_head_ = nullptr;
+    static std::mutex registry_mutex_;
+    static ThreadHeap* registry_head_;
+    static std::atomic<size_t> active_threads_;
+    static std::atomic<size_t> total_cached_bytes_;
+
+    ClassCache class_caches_[kNumSizeClasses];
+
+    // 最近被回收的大对象 span，最近放入的在表头。同样大小的大对象反复分配时
+    // 直接复用，不必每次都经过 CentralHeap 的锁。总字节数不超过 kLargeCacheBytes
+    // 与线程预算中较小的一个，超出时从表尾淘汰。large_cache_low_water_ 与 ClassCache::low_water 含义相同，
+    // 整个衰减周期内都没有被用到的这部分 span 在衰减时归还一半。
+    PageGroup* large_cache_ = nullptr;
+    size_t large_cache_bytes_ = 0;
+    size_t large_cache_low_water_ = 0;
+
+    // 托管链表按代划分：新分配的块挂在 young_lists_[0]，每次扫描后存活的块
+    // 整体移入下一个年龄的链表，在 young_lists_[kPromotionAge - 1] 中再存活一次
+    // 就晋升到老年代，状态改为 STATE_IN_USE_OLD。常规扫描只访问年轻代，代价
+    // 与分配速率成正比；老年代只在 old_frees_ 表明其中有足够多的垃圾、或者
+    // 距上次扫描已经过去 kOldSweepInterval 次时才扫描。
+    BlockHeader* young_lists_[kPromotionAge] = {};
+    BlockHeader* old_list_head_ = nullptr;
+    size_t old_block_count_ = 0;
+    uint32_t sweeps_since_old_ = 0;
+
+    // 任意线程释放或 retire 老年代块时递增。这是 ThreadHeap 中唯一会被其他线程
+    // 写入的字段，独占一条缓存行，避免远程释放弄脏所属线程频繁访问的数据
+    alignas(kCacheLineSize) std::atomic<size_t> old_frees_{0};
+    char old_frees_padding_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+
+    // epoch 回收：全局 epoch 从 1 开始，active_epoch_ 为 0 表示不在临界区。
+    // 在 epoch e 被 retire 的块，在全局 epoch 到达 e + 2 之后才能回收。
+    static std::atomic<uint64_t> global_epoch_;
+    std::atomic<uint64_t> active_epoch_{0};
+    unsigned critical_depth_ = 0;
+    uint64_t sweep_safe_epoch_ = 0;     // 本次扫描中已推进到的全局 epoch，0 表示尚未计算
+
+    ThreadHeapCounters counters_;
+    ThreadHeap* next_in_registry_ = nullptr;
+
+    // 堆采样：距离下一次采样还需分配的字节数，以及该线程的随机数状态
+    size_t bytes_until_sample_ = 0;
+    uint64_t sample_rng_state_ = 0;
+
+    uint64_t last_decay_ns_ = 0;
+    size_t published_cached_bytes_ = 0;         // 计入 total_cached_bytes_ 的本线程缓存字节数
+    uint64_t pressure_generation_seen_ = 0;     // 上次响应内存压力时的压力代数
+
+    // 保守式回收：所属线程及其栈的范围，挂起时记录的栈顶
+    pthread_t thread_{};
+    char* stack_base_ = nullptr;
+    void* volatile suspended_sp_ = nullptr;
+    bool thread_alive_ = true;          // 受 registry_mutex_ 保护
+};
+
+
+// 在作用域内保持当前线程处于 epoch 临界区
+class EpochGuard {
+public:
+    EpochGuard() : heap_(ThreadHeap::GetInstance()) { heap_->enter_critical(); }
+    ~EpochGuard() { heap_->exit_critical(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+private:
+    ThreadHeap* heap_;
 };
 
 #endif // GC_MALLOC_THREAD_CACHE_HPP
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef GC_MALLOC_TRACE_RECORDER_HPP
+#define GC_MALLOC_TRACE_RECORDER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+// =====================================================================
+// 二进制 trace 文件格式 (Trace File Format)
+// 文件以 TraceFileHeader 开头，之后是定长的 TraceRecord 序列。
+// 同一线程的记录按发生顺序排列，不同线程的记录按缓冲区刷新顺序交错，
+// 需要全局顺序时按 timestamp_ns 排序。
+// =====================================================================
+
+enum TraceOp : uint8_t {
+    TRACE_ALLOCATE = 1,
+    TRACE_FREE = 2,
+    TRACE_COLLECT = 3
+};
+
+struct TraceFileHeader {
+    char magic[8];              // "GCMTRACE"
+    uint32_t version;
+    uint32_t record_size;
+};
+
+struct TraceRecord {
+    uint64_t timestamp_ns;      // 自 start() 起经过的纳秒数
+    uint64_t address;           // 用户指针；TRACE_COLLECT 时为 0
+    uint64_t size;              // 请求大小；TRACE_FREE / TRACE_COLLECT 时为 0
+    uint32_t thread_id;         // 记录器内部分配的线程编号，从 0 开始
+    uint8_t op;                 // TraceOp
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord must stay 32 bytes.");
+
+
+/**
+ * @brief 可选的分配事件记录器。
+ *
+ * 关闭时热路径上只有一次 relaxed 读；开启后每个线程先写入自己的缓冲区，
+ * 满了再加锁批量写入文件。
+ *
+ * 这是一个线程安全的单例。
+ */
+class TraceRecorder {
+public:
+    static TraceRecorder& GetInstance();
+
+    static bool enabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    bool start(const char* path);
+    void stop();
+
+    void record(TraceOp op, const void* ptr, size_t size);
+
+    // 读取整个 trace 文件，格式不符时返回 false
+    static bool read_trace(const char* path, std::vector<TraceRecord>* out);
+
+public:
+    static constexpr uint32_t kVersion = 2;     // 2: size 与 thread_id 加宽
+    static constexpr size_t kBufferRecords = 512;
+
+private:
+    TraceRecorder() = default;
+    ~TraceRecorder() = default;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+private:
+    // 每个线程一个缓冲区，创建后不再释放，stop() 时统一刷新
+    struct ThreadBuffer {
+        std::mutex mutex;
+        uint32_t thread_id;
+        size_t count = 0;
+        TraceRecord records[kBufferRecords];
+        ThreadBuffer* next = nullptr;
+    };
+
+    ThreadBuffer* get_thread_buffer();
+    void flush_locked(ThreadBuffer* buffer);
+
+    static std::atomic<bool> enabled_;
+
+    std::mutex mutex_;                  // 保护 file_ 与 buffers_
+    FILE* file_ = nullptr;
+    ThreadBuffer* buffers_ = nullptr;
+    uint32_t next_thread_id_ = 0;
+    uint64_t start_ns_ = 0;
+};
+
+#endif // GC_MALLOC_TRACE_RECORDER_HPP
@@ -0,0 +1,107 @@
+#ifndef GC_MALLOC_TYPED_POOL_HPP
+#define GC_MALLOC_TYPED_POOL_HPP
+
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+#include "gc_malloc/SizeClassInfo.hpp"
+#include "gc_malloc/ConservativeCollector.hpp"
+
+#include <cstddef>
+#include <new>
+
+/**
+ * @brief 针对单一类型的对象池。
+ *
+ * 尺寸类别在编译期由 sizeof(T) 确定。每个线程持有一个小弹匣（magazine），
+ * 缓存若干已经从 ThreadHeap 取出的块：分配和释放在弹匣未空/未满时只是一次
+ * 数组读写，不经过尺寸映射和 ThreadHeap::allocate 的其余逻辑。弹匣为空时
+ * 通过 allocate_batch 批量补充；溢出时把一半用 ThreadHeap::deallocate 释放，
+ * 由所属线程照常 GC 回收到原来的 PageGroup。
+ *
+ * 弹匣里的块对 ThreadHeap 而言仍处于使用中，因此：
+ *   - 池中的对象可以在任意线程 destroy，块进入该线程的弹匣；
+ *   - 弹匣作为根登记给 ConservativeCollector，缓存的块不会被回收；
+ *   - 线程退出时弹匣中的块全部释放。
+ * 弹匣缓存的是未构造的内存，create/destroy 负责构造与析构。
+ */
+template <typename T>
+class TypedPool {
+public:
+    static constexpr size_t kSizeClass = SizeClassInfo::constexpr_index_for(sizeof(T) + sizeof(BlockHeader));
+    static_assert(kSizeClass < kNumSizeClasses, "TypedPool only supports types that fit a small size class.");
+    static_assert(alignof(T) <= alignof(BlockHeader), "Pool blocks are only aligned to the block header.");
+
+    static constexpr size_t kMagazineSize = 64;
+    static constexpr size_t kRefillCount = kMagazineSize / 2;
+
+    static void* allocate() {
+        Magazine& m = magazine_;
+        if (__builtin_expect(m.count > 0, 1)) {
+            return m.slots[--m.count];
+        }
+        return m.refill();
+    }
+
+    static void deallocate(void* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+        Magazine& m = magazine_;
+        if (__builtin_expect(m.count == kMagazineSize, 0)) {
+            m.flush(kMagazineSize / 2);
+        }
+        m.slots[m.count++] = ptr;
+    }
+
+    template <typename... Args>
+    static T* create(Args&&... args) {
+        void* mem = allocate();
+        return mem == nullptr ? nullptr : new (mem) T(static_cast<Args&&>(args)...);
+    }
+
+    static void destroy(T* obj) {
+        if (obj != nullptr) {
+            obj->~T();
+            deallocate(obj);
+        }
+    }
+
+    // 当前线程弹匣中缓存的块数
+    static size_t cached() { return magazine_.count; }
+
+private:
+    struct Magazine {
+        // 先创建 ThreadHeap，使它的退出处理晚于弹匣的析构执行，
+        // 弹匣释放的块还能在线程退出时被回收
+        Magazine() : heap(ThreadHeap::GetInstance()) {
+            ConservativeCollector::GetInstance().add_root(slots, sizeof(slots));
+        }
+
+        ~Magazine() {
+            flush(count);
+            ConservativeCollector::GetInstance().remove_root(slots);
+        }
+
+        void* refill() {
+            count = heap->allocate_batch(kSizeClass, slots, kRefillCount);
+            return count == 0 ? nullptr : slots[--count];
+        }
+
+        void flush(size_t n) {
+            while (n-- > 0) {
+                ThreadHeap::deallocate(slots[--count]);
+            }
+        }
+
+        ThreadHeap* heap;
+        size_t count = 0;
+        void* slots[kMagazineSize];
+    };
+
+    static thread_local Magazine magazine_;
+};
+
+template <typename T>
+thread_local typename TypedPool<T>::Magazine TypedPool<T>::magazine_;
+
+#endif // GC_MALLOC_TYPED_POOL_HPP
@@ -25,5 +25,38 @@ static inline uintptr_t atomic_load_acquire(const volatile uintptr_t* atomic_ptr
 #endif
 }
 
+// relaxed 版本只保证单次读写的原子性，不提供任何顺序保证。
+// 主要用于统计计数器这类“单写者、多读者、允许读到旧值”的场景。
+static inline void atomic_store_relaxed(volatile uintptr_t* atomic_ptr, uintptr_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(atomic_ptr, value, __ATOMIC_RELAXED);
+#else
+    *atomic_ptr = value;
+#endif
+}
+
+static inline uintptr_t atomic_load_relaxed(const volatile uintptr_t* atomic_ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(atomic_ptr, __ATOMIC_RELAXED);
+#else
+    return *atomic_ptr;
+#endif
+}
+
+// 当 *atomic_ptr 等于 expected 时写入 desired，返回是否写入成功。
+// 用于所属线程修改一个可能被其他线程同时释放的块的状态。
+static inline bool atomic_compare_exchange(volatile uintptr_t* atomic_ptr, uintptr_t expected, uintptr_t desired) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_compare_exchange_n(atomic_ptr, &expected, desired, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#else
+    if (*atomic_ptr != expected) {
+        return false;
+    }
+    *atomic_ptr = desired;
+    return true;
+#endif
+}
+
 
 #endif // GC_MALLOC_BASE_ATOMIC_OPS_HPP
\ No newline at end of file
@@ -18,7 +18,12 @@ extern "C" {
 #define MAP_PRIVATE     0x02
 #define MAP_ANONYMOUS   0x20
 #define MAP_ANON        MAP_ANONYMOUS
+#define MAP_FIXED       0x10
+#define MAP_FIXED_NOREPLACE 0x100000
 #define MAP_FAILED      (reinterpret_cast<void*>(-1))
+#define MADV_DONTNEED   4
+#define MS_SYNC         4
+#define MFD_CLOEXEC     0x0001U
 
 
 static inline void* mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
@@ -30,6 +35,22 @@ static inline int munmap(void* addr, size_t length) {
     return static_cast<int>(SYSCALL2(__NR_munmap, addr, length));
 }
 
+static inline int mincore(void* addr, size_t length, unsigned char* vec) {
+    return static_cast<int>(SYSCALL3(__NR_mincore, addr, length, vec));
+}
+
+static inline int madvise(void* addr, size_t length, int advice) {
+    return static_cast<int>(SYSCALL3(__NR_madvise, addr, length, advice));
+}
+
+static inline int msync(void* addr, size_t length, int flags) {
+    return static_cast<int>(SYSCALL3(__NR_msync, addr, length, flags));
+}
+
+static inline int memfd_create(const char* name, unsigned int flags) {
+    return static_cast<int>(SYSCALL2(__NR_memfd_create, name, flags));
+}
+
 
 #ifdef __cplusplus
 } // extern "C"
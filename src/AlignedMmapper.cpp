@@ -2,6 +2,7 @@
 #include "gc_malloc/sys/mman.hpp"
 #include <cassert>
 #include <cstdint>
+#include <unistd.h>
 
 
 // =====================================================================
@@ -59,4 +60,55 @@ void AlignedMmapper::deallocate_aligned(void* ptr, size_t size) {
     }
     
     munmap(ptr, size);
-}
\ No newline at end of file
+}
+
+
+void* AlignedMmapper::map_file_fixed(int fd, void* base, size_t size) {
+    assert(fd >= 0 && size > 0);
+
+    // 旧内核不认识 MAP_FIXED_NOREPLACE，会把 base 当作提示，因此还要检查返回的地址
+    void* ptr = mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+    if (ptr == MAP_FAILED) {
+        return nullptr;
+    }
+    if (ptr != base) {
+        munmap(ptr, size);
+        return nullptr;
+    }
+    return ptr;
+}
+
+
+void* AlignedMmapper::map_shared(int fd, size_t size) {
+    assert(fd >= 0 && size > 0);
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+
+int AlignedMmapper::create_shared_file(const char* name, size_t size) {
+    const int fd = memfd_create(name, MFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+
+bool AlignedMmapper::sync_file(void* ptr, size_t size) {
+    return msync(ptr, size, MS_SYNC) == 0;
+}
+
+
+bool AlignedMmapper::discard(void* ptr, size_t size) {
+    return madvise(ptr, size, MADV_DONTNEED) == 0;
+}
+
+
+bool AlignedMmapper::query_residency(void* ptr, size_t size, unsigned char* vec) {
+    return mincore(ptr, size, vec) == 0;
+}
@@ -0,0 +1,108 @@
+#include "gc_malloc/Arena.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+#include "gc_malloc/PageGroup.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+
+// =====================================================================
+// 构造与析构 (Constructor & Destructor)
+// =====================================================================
+
+Arena::Arena(size_t chunk_pages)
+    : chunk_pages_(std::min(std::max<size_t>(chunk_pages, 1), CentralHeap::kMaxPages))
+{
+}
+
+
+Arena::~Arena() {
+    CentralHeap& central = CentralHeap::GetInstance();
+    PageGroup* group = groups_;
+    while (group != nullptr) {
+        PageGroup* next = group->next_in_class_list;
+        central.release_pages(group);
+        group = next;
+    }
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+void Arena::reset() {
+    CentralHeap& central = CentralHeap::GetInstance();
+    PageGroup* group = groups_;
+    groups_ = nullptr;
+    held_pages_ = 0;
+    while (group != nullptr) {
+        PageGroup* next = group->next_in_class_list;
+        if (group == retained_) {
+            group->next_in_class_list = nullptr;
+            groups_ = group;
+            held_pages_ = group->page_count;
+        } else {
+            central.release_pages(group);
+        }
+        group = next;
+    }
+
+    if (retained_ != nullptr) {
+        cursor_ = reinterpret_cast<uintptr_t>(retained_->start_address);
+        limit_ = cursor_ + retained_->page_count * CentralHeap::kPageSize;
+    } else {
+        cursor_ = limit_ = 0;
+    }
+    allocated_bytes_ = 0;
+}
+
+
+// =====================================================================
+// 私有辅助函数实现 (Private Helper Implementation)
+// =====================================================================
+
+void* Arena::allocate_slow(size_t size, size_t alignment) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    if (size > CentralHeap::kRegionSizeBytes || alignment > CentralHeap::kPageSize) {
+        return nullptr;
+    }
+
+    // PageGroup 按页对齐，页内的对齐要求总能满足
+    const size_t pages = (size + CentralHeap::kPageSize - 1) / CentralHeap::kPageSize;
+    if (pages > chunk_pages_) {
+        // 超过 chunk 大小的请求单独占用一个 PageGroup，当前 chunk 剩余的空间继续使用
+        PageGroup* group = CentralHeap::GetInstance().acquire_pages(pages);
+        if (group == nullptr) {
+            return nullptr;
+        }
+        group->next_in_class_list = groups_;
+        groups_ = group;
+        held_pages_ += pages;
+        allocated_bytes_ += size;
+        return group->start_address;
+    }
+
+    if (!add_chunk(chunk_pages_)) {
+        return nullptr;
+    }
+    return allocate(size, alignment);
+}
+
+
+bool Arena::add_chunk(size_t num_pages) {
+    PageGroup* group = CentralHeap::GetInstance().acquire_pages(num_pages);
+    if (group == nullptr) {
+        return false;
+    }
+    group->next_in_class_list = groups_;
+    groups_ = group;
+    held_pages_ += num_pages;
+    if (retained_ == nullptr) {
+        retained_ = group;
+    }
+
+    cursor_ = reinterpret_cast<uintptr_t>(group->start_address);
+    limit_ = cursor_ + num_pages * CentralHeap::kPageSize;
+    return true;
+}
@@ -0,0 +1,370 @@
+#include "gc_malloc/ConservativeCollector.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+#include "gc_malloc/PageGroup.hpp"
+#include "gc_malloc/TraceRecorder.hpp"
+#include "gc_malloc/atomic_ops.hpp"
+#include "gc_malloc/sys/mman.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <csetjmp>
+#include <cstring>
+#include <sched.h>
+
+
+namespace {
+
+// =====================================================================
+// 停顿期间使用的临时数组 (Scratch Storage)
+// 其他线程被挂起时可能正持有 glibc malloc 的锁，因此标记阶段的所有
+// 临时内存都直接向内核申请。
+// =====================================================================
+
+template <typename T>
+class ScratchArray {
+public:
+    ScratchArray() = default;
+    ~ScratchArray() { release(); }
+
+    ScratchArray(const ScratchArray&) = delete;
+    ScratchArray& operator=(const ScratchArray&) = delete;
+
+    bool push_back(const T& value) {
+        if (size_ == capacity_ && !grow()) {
+            return false;
+        }
+        data_[size_++] = value;
+        return true;
+    }
+
+    T pop_back() { return data_[--size_]; }
+    void truncate(size_t n) { size_ = n; }
+
+    T& operator[](size_t i) { return data_[i]; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    static constexpr size_t kInitialBytes = 64 * 1024;
+
+    bool grow() {
+        const size_t new_capacity = capacity_ == 0 ? kInitialBytes / sizeof(T) : capacity_ * 2;
+        const size_t bytes = new_capacity * sizeof(T);
+        void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        // 原始系统调用失败时返回 -errno
+        if (reinterpret_cast<uintptr_t>(mem) > static_cast<uintptr_t>(-4096)) {
+            return false;
+        }
+        if (size_ > 0) {
+            std::memcpy(mem, data_, size_ * sizeof(T));
+        }
+        release();
+        data_ = static_cast<T*>(mem);
+        capacity_ = new_capacity;
+        return true;
+    }
+
+    void release() {
+        if (data_ != nullptr) {
+            munmap(data_, capacity_ * sizeof(T));
+            data_ = nullptr;
+        }
+    }
+
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+
+struct BlockEntry {
+    uintptr_t begin;            // 块头地址
+    uintptr_t end;              // 块尾（不含）
+    BlockHeader* block;
+    bool marked;
+};
+
+
+// 标记器：把一段内存中每个对齐的机器字当作可能的指针
+class Marker {
+public:
+    Marker(ScratchArray<BlockEntry>& blocks, ScratchArray<uint32_t>& stack)
+        : blocks_(blocks), stack_(stack) {
+        if (!blocks_.empty()) {
+            low_ = blocks_[0].begin;
+            for (BlockEntry& e : blocks_) {
+                high_ = std::max(high_, e.end);
+            }
+        }
+    }
+
+    void scan_range(const void* begin, const void* end) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(begin) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1);
+        const uintptr_t limit = reinterpret_cast<uintptr_t>(end);
+        for (; p + sizeof(uintptr_t) <= limit; p += sizeof(uintptr_t)) {
+            const uintptr_t word = *reinterpret_cast<const uintptr_t*>(p);
+            if (word >= low_ && word < high_) {
+                mark(word);
+            }
+        }
+    }
+
+    // 从标记栈中取出已标记的块，继续扫描它们的用户空间
+    void drain() {
+        while (!stack_.empty()) {
+            const BlockEntry& e = blocks_[stack_.pop_back()];
+            scan_range(reinterpret_cast<const void*>(e.begin + sizeof(BlockHeader)),
+                       reinterpret_cast<const void*>(e.end));
+        }
+    }
+
+    bool overflowed() const { return overflowed_; }
+
+private:
+    void mark(uintptr_t word) {
+        // 找到起始地址不大于 word 的最后一个块
+        BlockEntry* it = std::upper_bound(blocks_.begin(), blocks_.end(), word,
+                                          [](uintptr_t w, const BlockEntry& e) { return w < e.begin; });
+        if (it == blocks_.begin()) {
+            return;
+        }
+        --it;
+        // 用户不会持有指向块头的指针，只接受指向用户空间内部的值，
+        // 这样分配器自身的元数据和局部变量不会让块被误保留
+        if (word < it->begin + sizeof(BlockHeader) || word >= it->end || it->marked) {
+            return;
+        }
+        it->marked = true;
+        if (!stack_.push_back(static_cast<uint32_t>(it - blocks_.begin()))) {
+            overflowed_ = true;
+        }
+    }
+
+    ScratchArray<BlockEntry>& blocks_;
+    ScratchArray<uint32_t>& stack_;
+    uintptr_t low_ = 0;
+    uintptr_t high_ = 0;
+    bool overflowed_ = false;
+};
+
+
+// 不内联，保证返回的地址低于调用者栈帧中的所有局部变量
+__attribute__((noinline)) void* current_stack_pointer() {
+    return __builtin_frame_address(0);
+}
+
+uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+
+// =====================================================================
+// 单例模式实现 (Singleton Implementation)
+// =====================================================================
+
+ConservativeCollector& ConservativeCollector::GetInstance() {
+    static ConservativeCollector instance;
+    return instance;
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+void ConservativeCollector::enable() {
+    std::lock_guard<std::mutex> lock(collect_mutex_);
+    if (enabled()) {
+        return;
+    }
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &ConservativeCollector::suspend_handler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(kSuspendSignal, &action, nullptr);
+
+    enabled_.store(true, std::memory_order_release);
+}
+
+
+void ConservativeCollector::add_root(const void* begin, size_t size) {
+    std::lock_guard<std::mutex> lock(roots_mutex_);
+    const char* b = static_cast<const char*>(begin);
+    roots_.push_back({b, b + size});
+}
+
+
+void ConservativeCollector::remove_root(const void* begin) {
+    std::lock_guard<std::mutex> lock(roots_mutex_);
+    roots_.erase(std::remove_if(roots_.begin(), roots_.end(),
+                                [&](const Root& r) { return r.begin == begin; }),
+                 roots_.end());
+}
+
+
+bool ConservativeCollector::collect(Result* result) {
+    if (!enabled()) {
+        return false;
+    }
+
+    // 必须在拿注册表锁之前完成本线程的注册
+    ThreadHeap* self = ThreadHeap::GetInstance();
+
+    Result r{};
+    bool complete = true;
+    {
+        std::lock_guard<std::mutex> collect_lock(collect_mutex_);
+        std::lock_guard<std::mutex> roots_lock(roots_mutex_);
+        std::lock_guard<std::mutex> registry_lock(ThreadHeap::registry_mutex_);
+
+        // 1. 暂停其他线程。注册表锁保证这期间没有线程退出或新注册
+        const uint64_t pause_start = now_ns();
+        acks_.store(0, std::memory_order_relaxed);
+        size_t expected = 0;
+        for (ThreadHeap* heap = ThreadHeap::registry_head_; heap != nullptr; heap = heap->next_in_registry_) {
+            heap->suspended_sp_ = nullptr;
+            if (heap == self || !heap->thread_alive_) {
+                continue;
+            }
+            if (pthread_kill(heap->thread_, kSuspendSignal) == 0) {
+                expected++;
+            }
+        }
+        while (acks_.load(std::memory_order_acquire) < expected) {
+            sched_yield();
+        }
+
+        // 2. 收集所有托管链表中仍在使用的块，按地址排序
+        ScratchArray<BlockEntry> blocks;
+        for (ThreadHeap* heap = ThreadHeap::registry_head_; heap != nullptr; heap = heap->next_in_registry_) {
+            BlockHeader* lists[ThreadHeap::kPromotionAge + 1];
+            std::copy(heap->young_lists_, heap->young_lists_ + ThreadHeap::kPromotionAge, lists);
+            lists[ThreadHeap::kPromotionAge] = heap->old_list_head_;
+            for (BlockHeader* head : lists) {
+                for (BlockHeader* b = head; b != nullptr; b = b->next) {
+                    if (atomic_load_acquire(&b->state) == STATE_FREED) {
+                        continue;
+                    }
+                    const uintptr_t begin = reinterpret_cast<uintptr_t>(b);
+                    complete &= blocks.push_back({begin, begin + b->owner_group->block_size, b, false});
+                }
+            }
+        }
+        std::sort(blocks.begin(), blocks.end(),
+                  [](const BlockEntry& a, const BlockEntry& b) { return a.begin < b.begin; });
+        // 线程可能恰好挂起在两代链表的拼接过程中，同一个块会出现两次
+        BlockEntry* unique_end = std::unique(blocks.begin(), blocks.end(),
+                                             [](const BlockEntry& a, const BlockEntry& b) { return a.begin == b.begin; });
+        blocks.truncate(unique_end - blocks.begin());
+        r.scanned_blocks = blocks.size();
+
+        // 3. 从根出发标记：登记的根、其他线程的栈、本线程的栈与寄存器
+        ScratchArray<uint32_t> mark_stack;
+        Marker marker(blocks, mark_stack);
+        for (const Root& root : roots_) {
+            marker.scan_range(root.begin, root.end);
+            marker.drain();
+        }
+        for (ThreadHeap* heap = ThreadHeap::registry_head_; heap != nullptr; heap = heap->next_in_registry_) {
+            if (heap != self && heap->suspended_sp_ != nullptr && heap->stack_base_ != nullptr) {
+                marker.scan_range(heap->suspended_sp_, heap->stack_base_);
+                marker.drain();
+            }
+        }
+        jmp_buf registers;
+        std::memset(&registers, 0, sizeof(registers));      // 清掉未被 setjmp 覆盖的旧栈数据
+        setjmp(registers);
+        if (self->stack_base_ != nullptr) {
+            marker.scan_range(current_stack_pointer(), self->stack_base_);
+            marker.drain();
+        }
+        complete &= !marker.overflowed();
+
+        // 4. 恢复其他线程。未标记的块已经没有任何引用，线程恢复后也无法再
+        //    取得它们，清除可以在停顿之外进行
+        resume_generation_.fetch_add(1, std::memory_order_release);
+        r.pause_ns = now_ns() - pause_start;
+
+        // 5. 清除：临时内存不足导致标记不完整时不能释放任何块。
+        //    所属线程此时可能正在晋升这些块，因此用 CAS 置为 STATE_FREED；
+        //    已 retire 的块可能已被回收重用，留给 epoch 回收处理。
+        //    TraceRecorder 要加锁，只能在线程恢复之后记录；先记录再释放，
+        //    保证这次释放排在该地址被重新分配之前
+        if (complete) {
+            const bool tracing = TraceRecorder::enabled();
+            for (BlockEntry& e : blocks) {
+                if (e.marked) {
+                    r.marked_blocks++;
+                    continue;
+                }
+                uintptr_t state = atomic_load_acquire(&e.block->state);
+                if (state != STATE_IN_USE && state != STATE_IN_USE_OLD) {
+                    continue;
+                }
+                if (tracing) {
+                    TraceRecorder::GetInstance().record(TRACE_FREE, e.block + 1, 0);
+                }
+                while (!atomic_compare_exchange(&e.block->state, state, STATE_FREED)) {
+                    state = atomic_load_acquire(&e.block->state);
+                }
+                if (state == STATE_IN_USE_OLD) {
+                    e.block->owner_group->owner_heap->old_frees_.fetch_add(1, std::memory_order_relaxed);
+                }
+                r.freed_blocks++;
+                r.freed_bytes += e.end - e.begin;
+            }
+        }
+    }
+
+    // 被置为 STATE_FREED 的块由各自的线程在下一次 garbage_collect 时回收，
+    // 本线程的部分立即回收
+    self->garbage_collect();
+
+    if (result != nullptr) {
+        *result = r;
+    }
+    return complete;
+}
+
+
+// =====================================================================
+// 线程挂起 (Thread Suspension)
+// =====================================================================
+
+void ConservativeCollector::suspend_handler(int) {
+    const int saved_errno = errno;
+    GetInstance().suspend_current_thread();
+    errno = saved_errno;
+}
+
+
+void ConservativeCollector::suspend_current_thread() {
+    // 回收线程在所有线程确认挂起之后才会推进 resume_generation_，
+    // 因此必须在确认之前读取
+    const unsigned generation = resume_generation_.load(std::memory_order_acquire);
+
+    // 把被调用者保存的寄存器写到栈上；其余寄存器已由内核保存在信号栈帧中
+    jmp_buf registers;
+    std::memset(&registers, 0, sizeof(registers));
+    setjmp(registers);
+
+    ThreadHeap* heap = ThreadHeap::tls_instance_;
+    if (heap != nullptr) {
+        heap->suspended_sp_ = current_stack_pointer();
+    }
+
+    acks_.fetch_add(1, std::memory_order_acq_rel);
+    while (resume_generation_.load(std::memory_order_acquire) == generation) {
+        sched_yield();
+    }
+}
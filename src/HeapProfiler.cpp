@@ -0,0 +1,185 @@
+#include "gc_malloc/HeapProfiler.hpp"
+
+#include <cassert>
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <execinfo.h>
+
+
+// =====================================================================
+// 单例模式实现 (Singleton Implementation)
+// =====================================================================
+
+HeapProfiler& HeapProfiler::GetInstance() {
+    static HeapProfiler instance;
+    return instance;
+}
+
+
+// =====================================================================
+// 构造与析构 (Constructor & Destructor)
+// =====================================================================
+
+HeapProfiler::HeapProfiler() {
+    // 允许不修改代码、仅通过环境变量开启采样
+    const char* period = std::getenv("GC_MALLOC_SAMPLE_PERIOD");
+    if (period != nullptr) {
+        sample_period_.store(std::strtoull(period, nullptr, 10), std::memory_order_relaxed);
+    }
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+void HeapProfiler::set_sample_period(size_t bytes) {
+    sample_period_.store(bytes, std::memory_order_relaxed);
+}
+
+size_t HeapProfiler::sample_period() const {
+    return sample_period_.load(std::memory_order_relaxed);
+}
+
+
+size_t HeapProfiler::next_sample_distance(uint64_t* rng_state) const {
+    const size_t period = sample_period();
+    if (period == 0) {
+        return kDisabledRecheckBytes;
+    }
+
+    // xorshift64*，只为得到一个均匀分布的随机数，不要求密码学强度
+    uint64_t x = *rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *rng_state = x;
+    const uint64_t r = x * 0x2545F4914F6CDD1DULL;
+
+    // 指数分布的采样间隔使采样点在字节流上构成泊松过程，
+    // pprof 据此按 1 / (1 - e^(-size/period)) 还原真实分配量。
+    const double u = (static_cast<double>(r >> 11) + 1.0) / 9007199254740992.0;  // (0, 1]
+    const double distance = -std::log(u) * static_cast<double>(period);
+
+    if (distance < 1.0) {
+        return 1;
+    }
+    if (distance > static_cast<double>(SIZE_MAX / 2)) {
+        return SIZE_MAX / 2;
+    }
+    return static_cast<size_t>(distance);
+}
+
+
+void HeapProfiler::record_allocation(void* ptr, size_t size) {
+    assert(ptr != nullptr);
+
+    StackTrace trace;
+    void* frames[kMaxStackDepth + 3];
+    // 跳过 backtrace 自身所在的 record_allocation 以及 ThreadHeap 的两层调用
+    const int kSkipFrames = 3;
+    const int depth = backtrace(frames, kMaxStackDepth + kSkipFrames);
+    trace.depth = depth > kSkipFrames ? depth - kSkipFrames : 0;
+    std::memset(trace.frames, 0, sizeof(trace.frames));
+    std::memcpy(trace.frames, frames + (depth - trace.depth), trace.depth * sizeof(void*));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Bucket& bucket = buckets_[trace];
+    bucket.alloc_count++;
+    bucket.alloc_bytes += size;
+    live_samples_[ptr] = LiveSample{size, &bucket};
+}
+
+
+bool HeapProfiler::record_free(void* ptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = live_samples_.find(ptr);
+    if (it == live_samples_.end()) {
+        return false;
+    }
+
+    Bucket* bucket = it->second.bucket;
+    bucket->free_count++;
+    bucket->free_bytes += it->second.size;
+    live_samples_.erase(it);
+    return true;
+}
+
+
+size_t HeapProfiler::live_sample_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_samples_.size();
+}
+
+
+void HeapProfiler::write_profile(FILE* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    uint64_t inuse_count = 0, inuse_bytes = 0, alloc_count = 0, alloc_bytes = 0;
+    for (const auto& entry : buckets_) {
+        const Bucket& b = entry.second;
+        inuse_count += b.alloc_count - b.free_count;
+        inuse_bytes += b.alloc_bytes - b.free_bytes;
+        alloc_count += b.alloc_count;
+        alloc_bytes += b.alloc_bytes;
+    }
+
+    std::fprintf(out, "heap profile: %" PRIu64 ": %" PRIu64 " [%" PRIu64 ": %" PRIu64 "] @ heap_v2/%zu\n",
+                 inuse_count, inuse_bytes, alloc_count, alloc_bytes, sample_period());
+
+    for (const auto& entry : buckets_) {
+        const StackTrace& trace = entry.first;
+        const Bucket& b = entry.second;
+        std::fprintf(out, "%" PRIu64 ": %" PRIu64 " [%" PRIu64 ": %" PRIu64 "] @",
+                     b.alloc_count - b.free_count, b.alloc_bytes - b.free_bytes, b.alloc_count, b.alloc_bytes);
+        for (int i = 0; i < trace.depth; i++) {
+            std::fprintf(out, " %p", trace.frames[i]);
+        }
+        std::fputc('\n', out);
+    }
+
+    // pprof 需要映射表来把地址对应回各个二进制文件
+    std::fprintf(out, "\nMAPPED_LIBRARIES:\n");
+    FILE* maps = std::fopen("/proc/self/maps", "r");
+    if (maps != nullptr) {
+        char buf[4096];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), maps)) > 0) {
+            std::fwrite(buf, 1, n, out);
+        }
+        std::fclose(maps);
+    }
+}
+
+
+bool HeapProfiler::dump_profile(const char* path) {
+    FILE* out = std::fopen(path, "w");
+    if (out == nullptr) {
+        return false;
+    }
+    write_profile(out);
+    return std::fclose(out) == 0;
+}
+
+
+// =====================================================================
+// 私有辅助函数实现 (Private Helper Implementation)
+// =====================================================================
+
+bool HeapProfiler::StackTrace::operator==(const StackTrace& other) const {
+    return depth == other.depth &&
+           std::memcmp(frames, other.frames, depth * sizeof(void*)) == 0;
+}
+
+size_t HeapProfiler::StackTraceHash::operator()(const StackTrace& trace) const {
+    // FNV-1a
+    uint64_t h = 14695981039346656037ULL;
+    for (int i = 0; i < trace.depth; i++) {
+        h ^= reinterpret_cast<uintptr_t>(trace.frames[i]);
+        h *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(h);
+}
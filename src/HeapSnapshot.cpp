@@ -0,0 +1,264 @@
+#include "gc_malloc/HeapSnapshot.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cinttypes>
+#include <csignal>
+#include <cstring>
+#include <mutex>
+#include <semaphore.h>
+#include <thread>
+
+
+namespace {
+
+// 信号触发：处理函数只 sem_post，报告在后台线程中生成
+sem_t g_trigger_sem;
+std::mutex g_trigger_mutex;
+bool g_trigger_started = false;
+std::string g_trigger_path;
+
+void trigger_handler(int) {
+    const int saved_errno = errno;
+    sem_post(&g_trigger_sem);
+    errno = saved_errno;
+}
+
+void trigger_loop() {
+    for (;;) {
+        while (sem_wait(&g_trigger_sem) != 0) {
+            // 被其他信号打断时继续等待
+        }
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(g_trigger_mutex);
+            path = g_trigger_path;
+        }
+        HeapSnapshot::dump(path.c_str());
+    }
+}
+
+} // namespace
+
+
+// =====================================================================
+// 采集 (Capture)
+// =====================================================================
+
+void HeapSnapshot::capture(HeapSnapshotData* out) {
+    assert(out != nullptr);
+
+    out->threads.clear();
+    ThreadHeap::for_each_instance([&](const ThreadHeap& heap) {
+        out->threads.push_back({&heap, 0, 0, 0});
+    });
+
+    CentralHeap::GetInstance().collect_span_map(&out->span_map);
+
+    std::fill(std::begin(out->free_spans_by_pages), std::end(out->free_spans_by_pages), 0);
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        out->classes[i] = {SizeClassInfo::get_block_size_for_index(i), 0, 0, 0};
+    }
+    out->large_groups = 0;
+    out->cached_large_groups = 0;
+    out->other_groups = 0;
+    out->other_pages = 0;
+    out->header_bytes = 0;
+    out->tail_bytes = 0;
+    out->cached_block_bytes = 0;
+
+    for (const CentralHeap::SpanInfo& span : out->span_map.spans) {
+        if (span.free) {
+            out->free_spans_by_pages[std::min(span.page_count, CentralHeap::kMaxPages)]++;
+            continue;
+        }
+
+        auto thread = std::find_if(out->threads.begin(), out->threads.end(),
+                                   [&](const HeapSnapshotThread& t) { return t.heap == span.owner_heap; });
+        if (thread == out->threads.end() || span.block_size == 0) {
+            out->other_groups++;
+            out->other_pages += span.page_count;
+            continue;
+        }
+
+        const size_t bytes = span.page_count * CentralHeap::kPageSize;
+        const uint64_t in_use = span.block_in_used_count > 0 ? span.block_in_used_count : 0;
+        const uint64_t total = span.total_block_count > 0 ? span.total_block_count : 0;
+        thread->groups++;
+        thread->pages += span.page_count;
+        thread->in_use_bytes += in_use * span.block_size;
+        out->header_bytes += in_use * sizeof(BlockHeader);
+
+        const size_t index = SizeClassInfo::map_size_to_index(span.block_size);
+        if (index < kNumSizeClasses) {
+            HeapSnapshotClass& c = out->classes[index];
+            c.groups++;
+            c.in_use_blocks += in_use;
+            c.total_blocks += total;
+            out->tail_bytes += bytes > total * span.block_size ? bytes - total * span.block_size : 0;
+            out->cached_block_bytes += (total - std::min(in_use, total)) * span.block_size;
+        } else if (in_use == 0) {
+            out->cached_large_groups++;
+        } else {
+            out->large_groups++;
+            out->tail_bytes += bytes > span.block_size ? bytes - span.block_size : 0;
+        }
+    }
+}
+
+
+std::vector<std::string> HeapSnapshot::region_maps(const HeapSnapshotData& snapshot) {
+    std::vector<std::string> maps;
+    const std::vector<CentralHeap::SpanInfo>& spans = snapshot.span_map.spans;
+    size_t next_span = 0;
+
+    for (uintptr_t region : snapshot.span_map.regions) {
+        std::string map(CentralHeap::kPagesPerMmap, kMapUnknown);
+        const uintptr_t region_end = region + CentralHeap::kRegionSizeBytes;
+
+        // spans 与 regions 都按地址升序，一次遍历即可
+        while (next_span < spans.size() && spans[next_span].start < region) {
+            next_span++;
+        }
+        for (; next_span < spans.size() && spans[next_span].start < region_end; ++next_span) {
+            const CentralHeap::SpanInfo& span = spans[next_span];
+            char c;
+            if (span.free) {
+                c = kMapFree;
+            } else if (span.owner_heap == nullptr || span.block_size == 0) {
+                c = kMapOther;
+            } else if (SizeClassInfo::map_size_to_index(span.block_size) < kNumSizeClasses) {
+                if (span.total_block_count <= 0) {
+                    c = kMapUnknown;
+                } else if (span.block_in_used_count >= span.total_block_count) {
+                    c = kMapFull;
+                } else {
+                    c = static_cast<char>('0' + std::max(span.block_in_used_count, 0) * 10 / span.total_block_count);
+                }
+            } else {
+                c = span.block_in_used_count > 0 ? kMapLarge : kMapCachedLarge;
+            }
+            const size_t first = (span.start - region) / CentralHeap::kPageSize;
+            const size_t last = std::min(first + span.page_count, CentralHeap::kPagesPerMmap);
+            std::fill(map.begin() + first, map.begin() + last, c);
+        }
+        maps.push_back(std::move(map));
+    }
+    return maps;
+}
+
+
+// =====================================================================
+// 输出 (Reporting)
+// =====================================================================
+
+void HeapSnapshot::write(FILE* out, const HeapSnapshotData& s) {
+    const CentralHeap::SpanMap& map = s.span_map;
+    const size_t page = CentralHeap::kPageSize;
+
+    size_t free_pages = 0;
+    for (size_t pages = 1; pages <= CentralHeap::kMaxPages; pages++) {
+        free_pages += s.free_spans_by_pages[pages] * pages;
+    }
+
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "gc_malloc heap snapshot\n");
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "regions:                 %zu (%zu bytes)\n", map.regions.size(),
+                 map.regions.size() * CentralHeap::kRegionSizeBytes);
+    std::fprintf(out, "free spans:              %zu in address list, %zu in size lists%s, %zu bytes\n",
+                 map.addr_list_spans, map.size_list_spans,
+                 map.addr_list_spans == map.size_list_spans ? "" : " (MISMATCH)", free_pages * page);
+    std::fprintf(out, "page groups:             %zu large, %zu cached large, %zu other (%zu pages)\n",
+                 s.large_groups, s.cached_large_groups, s.other_groups, s.other_pages);
+    std::fprintf(out, "waste:                   %" PRIu64 " header bytes, %" PRIu64 " tail bytes, %" PRIu64
+                 " bytes in free blocks\n", s.header_bytes, s.tail_bytes, s.cached_block_bytes);
+
+    // 空闲 span 按页数以 2 的幂分桶
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "free span histogram (pages):\n");
+    for (size_t lo = 1; lo <= CentralHeap::kMaxPages; lo *= 2) {
+        const size_t hi = std::min(lo * 2 - 1, CentralHeap::kMaxPages);
+        size_t count = 0;
+        size_t pages = 0;
+        for (size_t p = lo; p <= hi; p++) {
+            count += s.free_spans_by_pages[p];
+            pages += s.free_spans_by_pages[p] * p;
+        }
+        if (count > 0) {
+            std::fprintf(out, "  %4zu-%-4zu %8zu spans %12zu bytes\n", lo, hi, count, pages * page);
+        }
+    }
+
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "size class utilization:\n");
+    std::fprintf(out, "%8s %8s %12s %12s %6s\n", "class", "groups", "in_use", "total", "util");
+    for (const HeapSnapshotClass& c : s.classes) {
+        if (c.groups == 0) {
+            continue;
+        }
+        std::fprintf(out, "%8zu %8zu %12" PRIu64 " %12" PRIu64 " %5.1f%%\n", c.block_size, c.groups,
+                     c.in_use_blocks, c.total_blocks,
+                     c.total_blocks == 0 ? 0.0 : 100.0 * c.in_use_blocks / c.total_blocks);
+    }
+
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "thread heaps:\n");
+    for (size_t i = 0; i < s.threads.size(); i++) {
+        const HeapSnapshotThread& t = s.threads[i];
+        std::fprintf(out, "  #%-4zu %p %6zu groups %8zu pages %12" PRIu64 " bytes in use\n",
+                     i, t.heap, t.groups, t.pages, t.in_use_bytes);
+    }
+
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "region map ('%c' free, '0'-'9' small group occupancy in tenths, '%c' full, "
+                 "'%c' large, '%c' cached large, '%c' other):\n",
+                 kMapFree, kMapFull, kMapLarge, kMapCachedLarge, kMapOther);
+    const std::vector<std::string> maps = region_maps(s);
+    for (size_t i = 0; i < maps.size(); i++) {
+        std::fprintf(out, "  0x%012" PRIxPTR " %s\n", map.regions[i], maps[i].c_str());
+    }
+}
+
+
+void HeapSnapshot::print(FILE* out) {
+    HeapSnapshotData s;
+    capture(&s);
+    write(out, s);
+}
+
+
+bool HeapSnapshot::dump(const char* path) {
+    FILE* out = std::fopen(path, "w");
+    if (out == nullptr) {
+        return false;
+    }
+    print(out);
+    return std::fclose(out) == 0;
+}
+
+
+bool HeapSnapshot::enable_signal_trigger(int signum, const char* path) {
+    if (path == nullptr) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(g_trigger_mutex);
+    g_trigger_path = path;
+    if (!g_trigger_started) {
+        if (sem_init(&g_trigger_sem, 0, 0) != 0) {
+            return false;
+        }
+        std::thread(trigger_loop).detach();
+        g_trigger_started = true;
+    }
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = &trigger_handler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    return sigaction(signum, &action, nullptr) == 0;
+}
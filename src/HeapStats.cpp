@@ -0,0 +1,185 @@
+#include "gc_malloc/HeapStats.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/MetadataAllocor.hpp"
+
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+
+
+// =====================================================================
+// 汇总 (Aggregation)
+// =====================================================================
+
+void HeapStats::collect(HeapStatsSnapshot* out) {
+    assert(out != nullptr);
+    std::memset(out, 0, sizeof(*out));
+
+    uint64_t refill_blocks[kNumSizeClasses] = {};
+    uint64_t released_blocks[kNumSizeClasses] = {};
+    uint64_t large_alloc_bytes = 0;
+    uint64_t large_free_bytes = 0;
+
+    ThreadHeap::for_each_instance([&](const ThreadHeap& heap) {
+        const ThreadHeapCounters& c = heap.counters();
+        out->thread_heap_count++;
+
+        for (size_t i = 0; i < kNumSizeClasses; i++) {
+            out->size_classes[i].alloc_count += c.alloc_count[i].load();
+            out->size_classes[i].free_count += c.free_count[i].load();
+            out->size_classes[i].refill_count += c.refill_count[i].load();
+            refill_blocks[i] += c.refill_blocks[i].load();
+            released_blocks[i] += c.released_blocks[i].load();
+        }
+
+        out->large_alloc_count += c.large_alloc_count.load();
+        out->large_free_count += c.large_free_count.load();
+        large_alloc_bytes += c.large_alloc_bytes.load();
+        large_free_bytes += c.large_free_bytes.load();
+        out->large_cache_hits += c.large_cache_hits.load();
+
+        out->gc_count += c.gc_count.load();
+        out->gc_total_ns += c.gc_total_ns.load();
+        out->gc_reclaimed_blocks += c.gc_reclaimed_blocks.load();
+        out->gc_swept_blocks += c.gc_swept_blocks.load();
+        out->gc_promoted_blocks += c.gc_promoted_blocks.load();
+        out->gc_old_sweeps += c.gc_old_sweeps.load();
+        if (c.gc_max_ns.load() > out->gc_max_ns) {
+            out->gc_max_ns = c.gc_max_ns.load();
+        }
+    });
+
+    // 空闲链表中的块数 = refill 切出的块 + 回收的块 - 分配出去的块 - 随 PageGroup 归还的块。
+    // 各计数器并非同一时刻读取，并发场景下结果只是近似值，这里做一次下限保护。
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+        SizeClassStats& sc = out->size_classes[i];
+        sc.block_size = SizeClassInfo::get_block_size_for_index(i);
+
+        const uint64_t in = refill_blocks[i] + sc.free_count;
+        const uint64_t out_blocks = sc.alloc_count + released_blocks[i];
+        sc.cached_blocks = in > out_blocks ? in - out_blocks : 0;
+        sc.cached_bytes = sc.cached_blocks * sc.block_size;
+    }
+    out->large_live_bytes = large_alloc_bytes > large_free_bytes ? large_alloc_bytes - large_free_bytes : 0;
+
+    CentralHeap::GetInstance().collect_stats(&out->central);
+
+    MetadataAllocator& metadata = MetadataAllocator::GetInstance();
+    out->metadata_objects = metadata.allocated_objects_count();
+    out->metadata_mapped_bytes = metadata.chunks_acquired() * metadata.chunk_size();
+}
+
+
+// =====================================================================
+// 输出 (Reporting)
+// =====================================================================
+
+void HeapStats::print(FILE* out) {
+    HeapStatsSnapshot s;
+    collect(&s);
+
+    uint64_t cached_bytes = 0;
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+        cached_bytes += s.size_classes[i].cached_bytes;
+    }
+
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "gc_malloc stats\n");
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "thread heaps:            %zu\n", s.thread_heap_count);
+    std::fprintf(out, "mapped bytes:            %zu\n", s.central.mapped_bytes);
+    std::fprintf(out, "resident bytes:          %zu\n", s.central.resident_bytes);
+    std::fprintf(out, "purged bytes:            %zu\n", s.central.purged_bytes);
+    std::fprintf(out, "central free bytes:      %zu (%zu spans)\n", s.central.free_bytes, s.central.free_span_count);
+    std::fprintf(out, "thread cached bytes:     %" PRIu64 "\n", cached_bytes);
+    std::fprintf(out, "large live bytes:        %" PRIu64 "\n", s.large_live_bytes);
+    std::fprintf(out, "large span cache hits:   %" PRIu64 "\n", s.large_cache_hits);
+    std::fprintf(out, "metadata:                %zu objects, %zu bytes mapped\n",
+                 s.metadata_objects, s.metadata_mapped_bytes);
+    std::fprintf(out, "gc sweeps:               %" PRIu64 " (total %" PRIu64 " ns, max %" PRIu64 " ns, %" PRIu64 " blocks reclaimed)\n",
+                 s.gc_count, s.gc_total_ns, s.gc_max_ns, s.gc_reclaimed_blocks);
+    std::fprintf(out, "gc generations:          %" PRIu64 " blocks swept, %" PRIu64 " promoted, %" PRIu64 " old sweeps\n",
+                 s.gc_swept_blocks, s.gc_promoted_blocks, s.gc_old_sweeps);
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "%6s %12s %12s %10s %12s %12s\n", "class", "allocs", "frees", "refills", "cached", "cached_bytes");
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+        const SizeClassStats& sc = s.size_classes[i];
+        std::fprintf(out, "%6zu %12" PRIu64 " %12" PRIu64 " %10" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+                     sc.block_size, sc.alloc_count, sc.free_count, sc.refill_count, sc.cached_blocks, sc.cached_bytes);
+    }
+    std::fprintf(out, "%6s %12" PRIu64 " %12" PRIu64 "\n", "large", s.large_alloc_count, s.large_free_count);
+    std::fprintf(out, "------------------------------------------------\n");
+    std::fprintf(out, "central free spans by pages:\n");
+    for (size_t pages = 1; pages <= CentralHeap::kMaxPages; pages++) {
+        if (s.central.free_spans_by_pages[pages] > 0) {
+            std::fprintf(out, "  %4zu pages: %zu\n", pages, s.central.free_spans_by_pages[pages]);
+        }
+    }
+}
+
+
+void HeapStats::dump_json(FILE* out) {
+    HeapStatsSnapshot s;
+    collect(&s);
+    const std::string json = to_json(s);
+    std::fwrite(json.data(), 1, json.size(), out);
+    std::fputc('\n', out);
+}
+
+
+std::string HeapStats::to_json(const HeapStatsSnapshot& s) {
+    std::string json;
+    char buf[256];
+
+    auto append = [&](const char* fmt, auto... args) {
+        std::snprintf(buf, sizeof(buf), fmt, args...);
+        json += buf;
+    };
+
+    json += "{";
+    append("\"thread_heaps\":%zu,", s.thread_heap_count);
+
+    json += "\"size_classes\":[";
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+        const SizeClassStats& sc = s.size_classes[i];
+        append("%s{\"block_size\":%zu,\"allocs\":%" PRIu64 ",\"frees\":%" PRIu64
+               ",\"refills\":%" PRIu64 ",\"cached_blocks\":%" PRIu64 ",\"cached_bytes\":%" PRIu64 "}",
+               i == 0 ? "" : ",", sc.block_size, sc.alloc_count, sc.free_count,
+               sc.refill_count, sc.cached_blocks, sc.cached_bytes);
+    }
+    json += "],";
+
+    append("\"large\":{\"allocs\":%" PRIu64 ",\"frees\":%" PRIu64 ",\"live_bytes\":%" PRIu64
+           ",\"cache_hits\":%" PRIu64 "},",
+           s.large_alloc_count, s.large_free_count, s.large_live_bytes, s.large_cache_hits);
+
+    append("\"gc\":{\"sweeps\":%" PRIu64 ",\"total_ns\":%" PRIu64 ",\"max_ns\":%" PRIu64 ",\"reclaimed_blocks\":%" PRIu64
+           ",\"swept_blocks\":%" PRIu64 ",\"promoted_blocks\":%" PRIu64 ",\"old_sweeps\":%" PRIu64 "},",
+           s.gc_count, s.gc_total_ns, s.gc_max_ns, s.gc_reclaimed_blocks,
+           s.gc_swept_blocks, s.gc_promoted_blocks, s.gc_old_sweeps);
+
+    append("\"central\":{\"mapped_bytes\":%zu,\"resident_bytes\":%zu,\"purged_bytes\":%zu,\"free_bytes\":%zu,"
+           "\"free_spans\":%zu,",
+           s.central.mapped_bytes, s.central.resident_bytes, s.central.purged_bytes, s.central.free_bytes,
+           s.central.free_span_count);
+    append("\"regions_mapped\":%" PRIu64 ",\"regions_unmapped\":%" PRIu64 ",\"acquires\":%" PRIu64
+           ",\"releases\":%" PRIu64 ",\"pages_in_use\":%" PRIu64 ",",
+           s.central.regions_mapped, s.central.regions_unmapped, s.central.acquire_count,
+           s.central.release_count, s.central.pages_in_use);
+
+    // 只输出非零项，形如 {"页数":span 数量}
+    json += "\"free_spans_by_pages\":{";
+    bool first = true;
+    for (size_t pages = 1; pages <= CentralHeap::kMaxPages; pages++) {
+        if (s.central.free_spans_by_pages[pages] > 0) {
+            append("%s\"%zu\":%zu", first ? "" : ",", pages, s.central.free_spans_by_pages[pages]);
+            first = false;
+        }
+    }
+    json += "}},";
+
+    append("\"metadata\":{\"objects\":%zu,\"mapped_bytes\":%zu}", s.metadata_objects, s.metadata_mapped_bytes);
+    json += "}";
+
+    return json;
+}
@@ -0,0 +1,137 @@
+#include "gc_malloc/MemoryLimit.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+std::atomic<size_t> MemoryLimit::threshold_{0};
+std::atomic<uint64_t> MemoryLimit::generation_{0};
+
+
+// =====================================================================
+// 单例模式实现 (Singleton Implementation)
+// =====================================================================
+
+MemoryLimit& MemoryLimit::GetInstance() {
+    static MemoryLimit instance;
+    return instance;
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+void MemoryLimit::set_limits(size_t soft_limit, size_t hard_limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 只设置了硬上限时，以它作为软上限
+    if (soft_limit == 0 || (hard_limit != 0 && soft_limit > hard_limit)) {
+        soft_limit = hard_limit;
+    }
+    soft_limit_ = soft_limit;
+    hard_limit_ = hard_limit;
+    threshold_.store(soft_limit_, std::memory_order_relaxed);
+}
+
+
+size_t MemoryLimit::soft_limit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return soft_limit_;
+}
+
+
+size_t MemoryLimit::hard_limit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hard_limit_;
+}
+
+
+bool MemoryLimit::load_cgroup_limit(const char* path, double soft_ratio) {
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char line[64] = {};
+    const bool ok = std::fgets(line, sizeof(line), file) != nullptr;
+    std::fclose(file);
+    if (!ok) {
+        return false;
+    }
+
+    if (std::strncmp(line, "max", 3) == 0) {
+        set_limits(0, 0);
+        return true;
+    }
+
+    char* end = nullptr;
+    const unsigned long long bytes = std::strtoull(line, &end, 10);
+    if (end == line || bytes == 0) {
+        return false;
+    }
+    set_limits(static_cast<size_t>(bytes * soft_ratio), static_cast<size_t>(bytes));
+    return true;
+}
+
+
+void MemoryLimit::set_hard_limit_callback(HardLimitCallback callback, void* arg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = callback;
+    callback_arg_ = arg;
+}
+
+
+void MemoryLimit::relieve_pressure() {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !over_threshold()) {
+        return;
+    }
+
+    // 通知其他线程在下一次需要新页时回收自己的缓存
+    request_trim();
+    soft_events_++;
+
+    CentralHeap& central = CentralHeap::GetInstance();
+    released_bytes_ += central.release_free_memory();
+    const size_t committed = central.committed_bytes();
+    reset_threshold_locked(committed);
+
+    if (hard_limit_ == 0 || callback_ == nullptr ||
+        committed < static_cast<size_t>(hard_limit_ * kHardLimitRatio)) {
+        return;
+    }
+    hard_events_++;
+    const HardLimitCallback callback = callback_;
+    void* arg = callback_arg_;
+    const size_t hard_limit = hard_limit_;
+
+    // 回调可能释放内存或调整上限，不能持锁调用
+    lock.unlock();
+    callback(committed, hard_limit, arg);
+}
+
+
+void MemoryLimit::collect_stats(Stats* out) {
+    assert(out != nullptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    out->soft_events = soft_events_;
+    out->hard_events = hard_events_;
+    out->released_bytes = released_bytes_;
+}
+
+
+// =====================================================================
+// 私有辅助函数实现 (Private Helper Implementation)
+// =====================================================================
+
+// 回收之后占用仍在软上限之上时，下一次等占用再增长一个步长才处理
+void MemoryLimit::reset_threshold_locked(size_t committed_bytes) {
+    if (soft_limit_ == 0) {
+        threshold_.store(0, std::memory_order_relaxed);
+        return;
+    }
+    const size_t step = std::max(kMinThresholdStep, soft_limit_ / 8);
+    threshold_.store(std::max(soft_limit_, committed_bytes + step), std::memory_order_relaxed);
+}
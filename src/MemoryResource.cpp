@@ -0,0 +1,77 @@
+#include "gc_malloc/MemoryResource.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+
+// =====================================================================
+// 单例模式实现 (Singleton Implementation)
+// =====================================================================
+
+ThreadHeapResource* ThreadHeapResource::GetInstance() {
+    static ThreadHeapResource instance;
+    return &instance;
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+void* ThreadHeapResource::allocate_bytes(size_t bytes, size_t alignment) {
+    ThreadHeap* heap = ThreadHeap::GetInstance();
+    if (alignment <= kNaturalAlignment) {
+        return heap->allocate(bytes);
+    }
+
+    // 用户空间至少按 8 字节对齐，多分配 alignment 字节足以放下对齐后的对象
+    // 和它前面保存原始指针的一个字
+    assert((alignment & (alignment - 1)) == 0);
+    if (bytes > SIZE_MAX - alignment) {
+        return nullptr;
+    }
+    void* raw = heap->allocate(bytes + alignment);
+    if (raw == nullptr) {
+        return nullptr;
+    }
+    const uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + alignment - 1) & ~(alignment - 1);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<void*>(aligned);
+}
+
+
+void ThreadHeapResource::deallocate_bytes(void* ptr, size_t bytes, size_t alignment) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (alignment <= kNaturalAlignment) {
+        ThreadHeap::deallocate(ptr, bytes);
+    } else {
+        ThreadHeap::deallocate(static_cast<void**>(ptr)[-1], bytes + alignment);
+    }
+}
+
+
+// =====================================================================
+// memory_resource 接口 (memory_resource Overrides)
+// =====================================================================
+
+void* ThreadHeapResource::do_allocate(size_t bytes, size_t alignment) {
+    void* ptr = allocate_bytes(bytes, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+
+void ThreadHeapResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    deallocate_bytes(ptr, bytes, alignment);
+}
+
+
+bool ThreadHeapResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return dynamic_cast<const ThreadHeapResource*>(&other) != nullptr;
+}
@@ -74,6 +74,16 @@ void MetadataAllocator::deallocate(void* ptr, size_t size) {
 }
 
 
+size_t MetadataAllocator::allocated_objects_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocated_objects_count_;
+}
+
+size_t MetadataAllocator::chunks_acquired() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunks_acquired_;
+}
+
 
 // =====================================================================
 // 私有辅助函数实现 (Private Helper Implementation)
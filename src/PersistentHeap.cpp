@@ -0,0 +1,182 @@
+#include "gc_malloc/PersistentHeap.hpp"
+#include "gc_malloc/AlignedMmapper.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// =====================================================================
+// 文件布局 (File Layout)
+// =====================================================================
+
+// 文件开头是 Header，之后的页由 SegmentHeap 按需分配，页堆内部的引用
+// 都是相对基址的偏移。根保存应用对象的绝对地址，基址固定因此仍然有效。
+struct PersistentHeap::Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t dirty;                     // 打开期间为 1，close() 写回后清零
+    uint64_t layout;                    // 尺寸类别表与头部布局的指纹
+    uintptr_t base;
+    SegmentHeap::State segment;
+    void* roots[kMaxRoots];
+};
+
+namespace {
+
+constexpr uint64_t kMagic = 0x50485f434d47ULL;     // "GMC_HP"
+constexpr uint32_t kVersion = 2;                   // 2: 页堆改为保存偏移
+
+size_t round_up(size_t n, size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+
+// =====================================================================
+// 构造与析构 (Constructor & Destructor)
+// =====================================================================
+
+PersistentHeap::~PersistentHeap() {
+    close();
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+bool PersistentHeap::open(const char* path, size_t size, uintptr_t base) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ != nullptr || path == nullptr) {
+        return false;
+    }
+
+    const int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t header_bytes = round_up(sizeof(Header), kPageSize);
+    Header* header = nullptr;
+    if (st.st_size == 0) {
+        // 新文件：按页取整，至少要容纳文件头和一页数据
+        size = round_up(size, kPageSize);
+        if (base % kPageSize != 0 || size < header_bytes + kPageSize ||
+            ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        header = static_cast<Header*>(AlignedMmapper::map_file_fixed(fd, reinterpret_cast<void*>(base), size));
+        if (header == nullptr) {
+            ::close(fd);
+            return false;
+        }
+        // 新扩展的文件内容全部为 0，只需填写非零字段
+        header->magic = kMagic;
+        header->version = kVersion;
+        header->layout = SegmentHeap::layout_fingerprint(sizeof(Header));
+        header->base = base;
+        SegmentHeap::initialize(&header->segment, size, header_bytes);
+        created_ = true;
+        was_clean_ = true;
+    } else {
+        // 已有文件：先读出文件头，确认格式后映射回它记录的基址
+        Header stored;
+        if (pread(fd, &stored, sizeof(stored), 0) != static_cast<ssize_t>(sizeof(stored)) ||
+            stored.magic != kMagic || stored.version != kVersion ||
+            stored.layout != SegmentHeap::layout_fingerprint(sizeof(Header)) ||
+            stored.segment.size != static_cast<size_t>(st.st_size) || stored.base % kPageSize != 0) {
+            ::close(fd);
+            return false;
+        }
+        header = static_cast<Header*>(
+            AlignedMmapper::map_file_fixed(fd, reinterpret_cast<void*>(stored.base), stored.segment.size));
+        if (header == nullptr) {
+            ::close(fd);
+            return false;
+        }
+        created_ = false;
+        was_clean_ = header->dirty == 0;
+    }
+
+    header->dirty = 1;
+    header_ = header;
+    segment_ = SegmentHeap(header, &header->segment);
+    fd_ = fd;
+    return true;
+}
+
+
+void PersistentHeap::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ == nullptr) {
+        return;
+    }
+
+    // 数据全部写回之后才清除 dirty，崩溃在两步之间时下次打开仍视为未正常关闭
+    const size_t size = header_->segment.size;
+    AlignedMmapper::sync_file(header_, size);
+    header_->dirty = 0;
+    AlignedMmapper::sync_file(header_, kPageSize);
+
+    AlignedMmapper::deallocate_aligned(header_, size);
+    ::close(fd_);
+    header_ = nullptr;
+    segment_ = SegmentHeap();
+    fd_ = -1;
+}
+
+
+size_t PersistentHeap::size() const {
+    return header_ == nullptr ? 0 : header_->segment.size;
+}
+
+
+void* PersistentHeap::allocate(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (header_ == nullptr) {
+        return nullptr;
+    }
+    const size_t offset = segment_.allocate(size);
+    return offset == 0 ? nullptr : reinterpret_cast<char*>(header_) + offset;
+}
+
+
+void PersistentHeap::deallocate(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    assert(header_ != nullptr);
+    segment_.deallocate(static_cast<size_t>(static_cast<char*>(ptr) - reinterpret_cast<char*>(header_)));
+}
+
+
+void PersistentHeap::set_root(size_t slot, void* ptr) {
+    assert(slot < kMaxRoots);
+    std::lock_guard<std::mutex> lock(mutex_);
+    assert(header_ != nullptr);
+    header_->roots[slot] = ptr;
+}
+
+
+void* PersistentHeap::root(size_t slot) const {
+    assert(slot < kMaxRoots);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_ == nullptr ? nullptr : header_->roots[slot];
+}
+
+
+bool PersistentHeap::sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_ != nullptr && AlignedMmapper::sync_file(header_, header_->segment.size);
+}
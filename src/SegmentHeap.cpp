@@ -0,0 +1,197 @@
+#include "gc_malloc/SegmentHeap.hpp"
+
+#include <cassert>
+
+
+// =====================================================================
+// 段内布局 (Segment Layout)
+// =====================================================================
+
+// 空闲页段的描述保存在它的第一页中
+struct SegmentHeap::FreeRun {
+    size_t page_count;
+    size_t next;
+};
+
+// 每个分配出去的块之前的头部，size 为块的总字节数（含头部）
+struct SegmentHeap::Block {
+    size_t size;
+    size_t next;                        // 仅在空闲链表中使用
+};
+
+namespace {
+
+size_t round_up(size_t n, size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+// 发布一次修改。此前写入的、尚未链入的内存必须先于它可见
+void publish(size_t* slot, size_t value) {
+    __atomic_store_n(slot, value, __ATOMIC_RELEASE);
+}
+
+} // namespace
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+void SegmentHeap::initialize(State* state, size_t size, size_t header_bytes) {
+    assert(size % kPageSize == 0 && header_bytes % kPageSize == 0 && header_bytes < size);
+    state->size = size;
+    state->top = header_bytes;
+}
+
+
+size_t SegmentHeap::allocate(size_t size) {
+    if (size > SIZE_MAX - sizeof(Block) - kPageSize) {
+        return 0;
+    }
+    const size_t need = size + sizeof(Block);
+    const size_t index = SizeClassInfo::map_size_to_index(need);
+
+    size_t offset;
+    if (index < kNumSizeClasses) {
+        if (state_->class_free[index] == 0 && !refill_class(index)) {
+            return 0;
+        }
+        offset = state_->class_free[index];
+        publish(&state_->class_free[index], at<Block>(offset)->next);
+    } else {
+        // 超过最大尺寸类别的请求整页分配
+        const size_t num_pages = round_up(need, kPageSize) / kPageSize;
+        offset = allocate_pages(num_pages);
+        if (offset == 0) {
+            return 0;
+        }
+        at<Block>(offset)->size = num_pages * kPageSize;
+    }
+    at<Block>(offset)->next = 0;
+    return offset + sizeof(Block);
+}
+
+
+void SegmentHeap::deallocate(size_t offset) {
+    assert(offset >= kPageSize + sizeof(Block) && offset < state_->size);
+    offset -= sizeof(Block);
+    Block* block = at<Block>(offset);
+
+    const size_t index = SizeClassInfo::map_size_to_index(block->size);
+    if (index < kNumSizeClasses) {
+        assert(SizeClassInfo::get_block_size_for_index(index) == block->size);
+        block->next = state_->class_free[index];
+        publish(&state_->class_free[index], offset);
+    } else {
+        release_pages(offset, block->size / kPageSize);
+    }
+}
+
+
+uint64_t SegmentHeap::layout_fingerprint(size_t header_size) {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t v) {
+        hash ^= v;
+        hash *= 1099511628211ULL;
+    };
+    mix(header_size);
+    mix(kNumSizeClasses);
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        mix(kSizeClassBlockSizes[i]);
+        mix(SizeClassInfo::get_pages_to_acquire_for_index(i));
+    }
+    return hash;
+}
+
+
+// =====================================================================
+// 私有辅助函数实现 (Private Helper Implementation)
+// =====================================================================
+
+// 首次适配：从空闲页段的尾部切下所需的页，这样剩余部分的描述不用移动；
+// 没有合适的页段时从 top 之后取新页
+size_t SegmentHeap::allocate_pages(size_t num_pages) {
+    size_t* link = &state_->free_runs;
+    for (size_t offset = *link; offset != 0; offset = *link) {
+        FreeRun* run = at<FreeRun>(offset);
+        if (run->page_count == num_pages) {
+            publish(link, run->next);
+            return offset;
+        }
+        if (run->page_count > num_pages) {
+            const size_t remaining = run->page_count - num_pages;
+            publish(&run->page_count, remaining);
+            return offset + remaining * kPageSize;
+        }
+        link = &run->next;
+    }
+
+    const size_t bytes = num_pages * kPageSize;
+    if (bytes > state_->size - state_->top) {
+        return 0;
+    }
+    const size_t offset = state_->top;
+    publish(&state_->top, offset + bytes);
+    return offset;
+}
+
+
+// 按偏移插入空闲页段并与相邻页段合并，合并后紧邻 top 的页段直接退回到 top。
+// 每种情况都只有最后一次存储让新状态生效，此前中断时释放的页只是泄漏：
+// 摘下页段总是先于扩大另一个页段或降低 top
+void SegmentHeap::release_pages(size_t offset, size_t num_pages) {
+    size_t* prev_link = nullptr;
+    size_t* link = &state_->free_runs;
+    while (*link != 0 && *link < offset) {
+        prev_link = link;
+        link = &at<FreeRun>(*link)->next;
+    }
+    const size_t prev = prev_link == nullptr ? 0 : *prev_link;
+    const size_t next = *link;
+
+    size_t end = offset + num_pages * kPageSize;
+    size_t following = next;
+    if (next != 0 && end == next) {
+        end += at<FreeRun>(next)->page_count * kPageSize;
+        following = at<FreeRun>(next)->next;
+    }
+    const bool merge_prev = prev != 0 && prev + at<FreeRun>(prev)->page_count * kPageSize == offset;
+    const size_t start = merge_prev ? prev : offset;
+
+    if (following == 0 && end == state_->top) {
+        // 从链表中摘下被合并的页段，再退回 top
+        publish(merge_prev ? prev_link : link, 0);
+        publish(&state_->top, start);
+    } else if (merge_prev) {
+        if (following != next) {
+            publish(&at<FreeRun>(prev)->next, following);
+        }
+        publish(&at<FreeRun>(prev)->page_count, (end - prev) / kPageSize);
+    } else {
+        FreeRun* run = at<FreeRun>(offset);
+        run->page_count = (end - offset) / kPageSize;
+        run->next = following;
+        publish(link, offset);
+    }
+}
+
+
+// 按尺寸类别表一次取 pages_to_acquire 页，全部切分后挂入空闲链表
+bool SegmentHeap::refill_class(size_t index) {
+    const size_t num_pages = SizeClassInfo::get_pages_to_acquire_for_index(index);
+    const size_t block_size = SizeClassInfo::get_block_size_for_index(index);
+    const size_t pages = allocate_pages(num_pages);
+    if (pages == 0) {
+        return false;
+    }
+
+    const size_t num_blocks = num_pages * kPageSize / block_size;
+    for (size_t i = num_blocks; i-- > 0;) {
+        const size_t offset = pages + i * block_size;
+        Block* block = at<Block>(offset);
+        block->size = block_size;
+        block->next = state_->class_free[index];
+        publish(&state_->class_free[index], offset);
+    }
+    return true;
+}
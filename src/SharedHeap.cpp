@@ -0,0 +1,196 @@
+#include "gc_malloc/SharedHeap.hpp"
+#include "gc_malloc/AlignedMmapper.hpp"
+
+#include <cassert>
+#include <cerrno>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// =====================================================================
+// 段布局 (Segment Layout)
+// =====================================================================
+
+// 段首是 Header，之后的页由 SegmentHeap 按需分配，与 PersistentHeap 相同。
+// 所有引用都是相对段首的偏移，0 表示空。
+struct SharedHeap::Header {
+    uint64_t magic;
+    uint64_t layout;                    // 尺寸类别表与头部布局的指纹，各进程必须一致
+    pthread_mutex_t mutex;              // PTHREAD_PROCESS_SHARED | PTHREAD_MUTEX_ROBUST
+    SegmentHeap::State segment;
+    size_t roots[kMaxRoots];
+};
+
+namespace {
+
+constexpr uint64_t kMagic = 0x50485f53484d47ULL;   // "GMHS_HP"
+
+size_t round_up(size_t n, size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+
+// =====================================================================
+// 构造与析构 (Constructor & Destructor)
+// =====================================================================
+
+SharedHeap::~SharedHeap() {
+    detach();
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+bool SharedHeap::create(size_t size, const char* name) {
+    if (header_ != nullptr) {
+        return false;
+    }
+    size = round_up(size, kPageSize);
+    if (size < round_up(sizeof(Header), kPageSize) + kPageSize) {
+        return false;
+    }
+    const int fd = AlignedMmapper::create_shared_file(name, size);
+    if (fd < 0) {
+        return false;
+    }
+    return map(fd, true);
+}
+
+
+bool SharedHeap::attach(int fd) {
+    if (header_ != nullptr || fd < 0) {
+        return false;
+    }
+    const int own_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (own_fd < 0) {
+        return false;
+    }
+    return map(own_fd, false);
+}
+
+
+void SharedHeap::detach() {
+    if (header_ == nullptr) {
+        return;
+    }
+    AlignedMmapper::deallocate_aligned(header_, header_->segment.size);
+    close(fd_);
+    header_ = nullptr;
+    segment_ = SegmentHeap();
+    fd_ = -1;
+}
+
+
+size_t SharedHeap::size() const {
+    return header_ == nullptr ? 0 : header_->segment.size;
+}
+
+
+void* SharedHeap::allocate(size_t size) {
+    if (header_ == nullptr) {
+        return nullptr;
+    }
+    lock();
+    const size_t offset = segment_.allocate(size);
+    unlock();
+    return from_offset(offset);
+}
+
+
+void SharedHeap::deallocate(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    assert(header_ != nullptr);
+    lock();
+    segment_.deallocate(to_offset(ptr));
+    unlock();
+}
+
+
+void SharedHeap::set_root(size_t slot, void* ptr) {
+    assert(slot < kMaxRoots && header_ != nullptr);
+    __atomic_store_n(&header_->roots[slot], to_offset(ptr), __ATOMIC_RELEASE);
+}
+
+
+void* SharedHeap::root(size_t slot) const {
+    assert(slot < kMaxRoots);
+    if (header_ == nullptr) {
+        return nullptr;
+    }
+    return from_offset(__atomic_load_n(&header_->roots[slot], __ATOMIC_ACQUIRE));
+}
+
+
+// =====================================================================
+// 私有辅助函数实现 (Private Helper Implementation)
+// =====================================================================
+
+// 映射 fd 并接管它。initialize 为 true 时段是新建的，内容全部为 0
+bool SharedHeap::map(int fd, bool initialize) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    Header* header = static_cast<Header*>(AlignedMmapper::map_shared(fd, size));
+    if (header == nullptr) {
+        close(fd);
+        return false;
+    }
+
+    // 布局指纹，保证各进程对尺寸类别与段头布局的理解一致
+    const uint64_t layout = SegmentHeap::layout_fingerprint(sizeof(Header));
+
+    if (initialize) {
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        const int rc = pthread_mutex_init(&header->mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+        if (rc != 0) {
+            AlignedMmapper::deallocate_aligned(header, size);
+            close(fd);
+            return false;
+        }
+        header->layout = layout;
+        SegmentHeap::initialize(&header->segment, size, round_up(sizeof(Header), kPageSize));
+        // magic 最后写入，attach 看到它时其余字段都已初始化
+        __atomic_store_n(&header->magic, kMagic, __ATOMIC_RELEASE);
+    } else if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != kMagic ||
+               header->layout != layout || header->segment.size != size) {
+        AlignedMmapper::deallocate_aligned(header, size);
+        close(fd);
+        return false;
+    }
+
+    header_ = header;
+    segment_ = SegmentHeap(header, &header->segment);
+    fd_ = fd;
+    return true;
+}
+
+
+void SharedHeap::lock() const {
+    const int rc = pthread_mutex_lock(&header_->mutex);
+    if (rc == EOWNERDEAD) {
+        // 上一个持锁进程在临界区内退出，接手后继续使用
+        pthread_mutex_consistent(&header_->mutex);
+    } else {
+        assert(rc == 0);
+    }
+}
+
+
+void SharedHeap::unlock() const {
+    pthread_mutex_unlock(&header_->mutex);
+}
@@ -0,0 +1,205 @@
+#include "gc_malloc/SizeClassGenerator.hpp"
+#include "gc_malloc/SizeClassInfo.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+
+namespace {
+
+// 尾部浪费比例相差不超过这个值时，优先选择页数更少的方案
+constexpr double kTailTolerance = 1.0 / 128;
+
+size_t round_up(size_t n, size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+// 每个块均摊到的 PageGroup 尾部浪费
+double amortized_tail(size_t block_size, size_t pages) {
+    const size_t bytes = pages * CentralHeap::kPageSize;
+    const size_t blocks = bytes / block_size;
+    return static_cast<double>(bytes - blocks * block_size) / blocks;
+}
+
+} // namespace
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+bool SizeClassGenerator::generate(const std::vector<SizeHistogramEntry>& histogram,
+                                  const SizeClassGeneratorOptions& options,
+                                  std::vector<GeneratedSizeClass>* out) {
+    assert(out != nullptr);
+    const size_t min_block = round_up(sizeof(BlockHeader) + 1, options.alignment);
+    if (options.num_classes == 0 || options.alignment == 0 ||
+        options.max_block_size % options.alignment != 0 || options.max_block_size < min_block ||
+        options.max_block_size > options.max_pages * CentralHeap::kPageSize) {
+        return false;
+    }
+
+    // 1. 候选块大小：每个请求大小向上对齐后的块大小，外加必须覆盖的最大块
+    std::vector<size_t> candidates;
+    for (const SizeHistogramEntry& e : histogram) {
+        const size_t need = e.size + sizeof(BlockHeader);
+        if (e.count > 0 && need <= options.max_block_size) {
+            candidates.push_back(round_up(need, options.alignment));
+        }
+    }
+    candidates.push_back(options.max_block_size);
+    // 当前表中的块大小作为零权重候选：直方图没有覆盖到的区间也能分到类别，
+    // 不至于全部落到最大类别上
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        const size_t block_size = SizeClassInfo::get_block_size_for_index(i);
+        if (block_size % options.alignment == 0 && block_size >= min_block && block_size < options.max_block_size) {
+            candidates.push_back(block_size);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // 2. 前缀和：weight[i] 为落在第 i 个候选上的请求数，need_sum[i] 为它们的 (请求+头部) 总字节数
+    const size_t m = candidates.size();
+    std::vector<double> weight_prefix(m + 1, 0.0);
+    std::vector<double> need_prefix(m + 1, 0.0);
+    {
+        std::vector<double> weight(m, 0.0);
+        std::vector<double> need_sum(m, 0.0);
+        for (const SizeHistogramEntry& e : histogram) {
+            const size_t need = e.size + sizeof(BlockHeader);
+            if (e.count == 0 || need > options.max_block_size) {
+                continue;
+            }
+            const size_t i = std::lower_bound(candidates.begin(), candidates.end(), need) - candidates.begin();
+            weight[i] += static_cast<double>(e.count);
+            need_sum[i] += static_cast<double>(e.count) * need;
+        }
+        for (size_t i = 0; i < m; ++i) {
+            weight_prefix[i + 1] = weight_prefix[i] + weight[i];
+            need_prefix[i + 1] = need_prefix[i] + need_sum[i];
+        }
+    }
+
+    std::vector<size_t> pages(m);
+    std::vector<double> tail(m);
+    for (size_t i = 0; i < m; ++i) {
+        pages[i] = choose_pages(candidates[i], options);
+        tail[i] = amortized_tail(candidates[i], pages[i]);
+    }
+
+    // 候选 (lo, hi] 区间的请求全部使用块大小 candidates[hi] 时的总浪费
+    auto cost = [&](size_t lo, size_t hi) {
+        const double w = weight_prefix[hi + 1] - weight_prefix[lo];
+        const double need = need_prefix[hi + 1] - need_prefix[lo];
+        return w * (candidates[hi] + tail[hi]) - need;
+    };
+
+    // 3. dp[k][j]: 用 k 个类别覆盖候选 0..j 且第 k 个类别恰为 candidates[j] 时的最小浪费
+    const size_t num_classes = std::min(options.num_classes, m);
+    const double kInf = std::numeric_limits<double>::infinity();
+    std::vector<std::vector<double>> dp(num_classes + 1, std::vector<double>(m, kInf));
+    std::vector<std::vector<size_t>> from(num_classes + 1, std::vector<size_t>(m, 0));
+    for (size_t j = 0; j < m; ++j) {
+        dp[1][j] = cost(0, j);
+    }
+    for (size_t k = 2; k <= num_classes; ++k) {
+        for (size_t j = k - 1; j < m; ++j) {
+            for (size_t i = k - 2; i < j; ++i) {
+                const double c = dp[k - 1][i] + cost(i + 1, j);
+                if (c < dp[k][j]) {
+                    dp[k][j] = c;
+                    from[k][j] = i;
+                }
+            }
+        }
+    }
+
+    // 最后一个类别必须是 max_block_size；浪费相同时取更多的类别
+    size_t best_k = 1;
+    for (size_t k = 2; k <= num_classes; ++k) {
+        if (dp[k][m - 1] <= dp[best_k][m - 1]) {
+            best_k = k;
+        }
+    }
+
+    // 4. 回溯出类别序列
+    std::vector<size_t> chosen;
+    for (size_t k = best_k, j = m - 1; k >= 1; --k) {
+        chosen.push_back(j);
+        j = from[k][j];
+    }
+    std::reverse(chosen.begin(), chosen.end());
+
+    out->clear();
+    for (size_t j : chosen) {
+        out->push_back({candidates[j], pages[j]});
+    }
+    return true;
+}
+
+
+size_t SizeClassGenerator::choose_pages(size_t block_size, const SizeClassGeneratorOptions& options) {
+    assert(block_size > 0);
+    const size_t page = CentralHeap::kPageSize;
+    size_t min_pages = (options.min_blocks_per_group * block_size + page - 1) / page;
+    min_pages = std::max<size_t>(1, std::min(min_pages, options.max_pages));
+    while (min_pages * page < block_size) {
+        min_pages++;
+    }
+
+    double best = std::numeric_limits<double>::infinity();
+    for (size_t p = min_pages; p <= options.max_pages; ++p) {
+        const size_t bytes = p * page;
+        best = std::min(best, static_cast<double>(bytes % block_size) / bytes);
+    }
+    for (size_t p = min_pages; p <= options.max_pages; ++p) {
+        const size_t bytes = p * page;
+        if (static_cast<double>(bytes % block_size) / bytes <= best + kTailTolerance) {
+            return p;
+        }
+    }
+    return min_pages;
+}
+
+
+double SizeClassGenerator::expected_waste(const std::vector<SizeHistogramEntry>& histogram,
+                                          const std::vector<GeneratedSizeClass>& classes) {
+    double waste = 0.0;
+    double total = 0.0;
+    for (const SizeHistogramEntry& e : histogram) {
+        const size_t need = e.size + sizeof(BlockHeader);
+        for (const GeneratedSizeClass& c : classes) {
+            if (c.block_size >= need) {
+                const double n = static_cast<double>(e.count);
+                waste += n * (c.block_size - need + amortized_tail(c.block_size, c.pages_to_acquire));
+                total += n;
+                break;
+            }
+        }
+    }
+    return total > 0 ? waste / total : 0.0;
+}
+
+
+void SizeClassGenerator::current_classes(std::vector<GeneratedSizeClass>* out) {
+    assert(out != nullptr);
+    out->clear();
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        out->push_back({SizeClassInfo::get_block_size_for_index(i),
+                        SizeClassInfo::get_pages_to_acquire_for_index(i)});
+    }
+}
+
+
+void SizeClassGenerator::write_table(FILE* out, const std::vector<GeneratedSizeClass>& classes) {
+    std::fprintf(out, "// 由 tools/gen_size_classes 生成的尺寸类别表。\n");
+    std::fprintf(out, "// 格式同 include/gc_malloc/SizeClassTable.def：SIZE_CLASS(block_size, pages_to_acquire)\n");
+    std::fprintf(out, "// 本文件会被多次包含，不加 include guard。\n\n");
+    for (const GeneratedSizeClass& c : classes) {
+        std::fprintf(out, "SIZE_CLASS( %6zu, %6zu )\n", c.block_size, c.pages_to_acquire);
+    }
+}
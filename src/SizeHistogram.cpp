@@ -0,0 +1,153 @@
+#include "gc_malloc/SizeHistogram.hpp"
+#include "gc_malloc/HeapStats.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+
+
+std::atomic<bool> SizeHistogram::enabled_{false};
+
+// 每个线程一份计数数组，创建后不再释放，由全局链表串起来供汇总
+struct SizeHistogram::ThreadHistogram {
+    StatCounter counts[kNumBuckets];
+    ThreadHistogram* next = nullptr;
+};
+
+std::mutex SizeHistogram::registry_mutex_;
+SizeHistogram::ThreadHistogram* SizeHistogram::registry_head_ = nullptr;
+
+
+// =====================================================================
+// 分桶 (Bucketing)
+// =====================================================================
+
+size_t SizeHistogram::bucket_index(size_t size) {
+    if (size <= kLinearLimit) {
+        return size == 0 ? 0 : (size - 1) / kLinearStep;
+    }
+    if (size > kMaxTrackedSize) {
+        return kNumBuckets - 1;
+    }
+
+    // 区间 (2^k, 2^(k+1)] 均分为 16 份
+    const size_t v = size - 1;
+    const size_t k = 63 - __builtin_clzll(v);
+    const size_t sub = (v >> (k - kSubBucketBits)) & ((1 << kSubBucketBits) - 1);
+    return kNumLinearBuckets + (k - 10) * (1 << kSubBucketBits) + sub;
+}
+
+size_t SizeHistogram::bucket_upper_bound(size_t index) {
+    assert(index < kNumBuckets);
+    if (index < kNumLinearBuckets) {
+        return (index + 1) * kLinearStep;
+    }
+    if (index == kNumBuckets - 1) {
+        return SIZE_MAX;
+    }
+
+    const size_t i = index - kNumLinearBuckets;
+    const size_t k = 10 + (i >> kSubBucketBits);
+    const size_t sub = i & ((1 << kSubBucketBits) - 1);
+    return ((1 << kSubBucketBits) + sub + 1) << (k - kSubBucketBits);
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+void SizeHistogram::enable() {
+    enabled_.store(true, std::memory_order_release);
+}
+
+void SizeHistogram::disable() {
+    enabled_.store(false, std::memory_order_release);
+}
+
+void SizeHistogram::reset() {
+    // 与所属线程的递增并发时可能丢掉少量计数，直方图只用于统计，可以接受
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (ThreadHistogram* h = registry_head_; h != nullptr; h = h->next) {
+        for (size_t i = 0; i < kNumBuckets; ++i) {
+            atomic_store_relaxed(&h->counts[i].value, 0);
+        }
+    }
+}
+
+void SizeHistogram::record(size_t size) {
+    get_thread_histogram()->counts[bucket_index(size)].add(1);
+}
+
+void SizeHistogram::collect(std::vector<SizeHistogramEntry>* out) {
+    assert(out != nullptr);
+
+    uint64_t totals[kNumBuckets] = {};
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (ThreadHistogram* h = registry_head_; h != nullptr; h = h->next) {
+            for (size_t i = 0; i < kNumBuckets; ++i) {
+                totals[i] += h->counts[i].load();
+            }
+        }
+    }
+
+    out->clear();
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        if (totals[i] != 0) {
+            out->push_back({bucket_upper_bound(i), totals[i]});
+        }
+    }
+}
+
+void SizeHistogram::dump(FILE* out) {
+    std::vector<SizeHistogramEntry> entries;
+    collect(&entries);
+
+    std::fprintf(out, "# gc_malloc request size histogram\n");
+    std::fprintf(out, "# <size> <count>, size is the bucket upper bound\n");
+    for (const SizeHistogramEntry& e : entries) {
+        std::fprintf(out, "%zu %" PRIu64 "\n", e.size, e.count);
+    }
+}
+
+bool SizeHistogram::read(FILE* in, std::vector<SizeHistogramEntry>* out) {
+    assert(out != nullptr);
+    out->clear();
+
+    char line[256];
+    while (std::fgets(line, sizeof(line), in) != nullptr) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        unsigned long long size;
+        unsigned long long count;
+        if (std::sscanf(line, "%llu %llu", &size, &count) != 2 || size == 0) {
+            return false;
+        }
+        out->push_back({static_cast<size_t>(size), static_cast<uint64_t>(count)});
+    }
+
+    std::sort(out->begin(), out->end(), [](const SizeHistogramEntry& a, const SizeHistogramEntry& b) {
+        return a.size < b.size;
+    });
+    return true;
+}
+
+
+// =====================================================================
+// 私有辅助函数实现 (Private Helper Implementation)
+// =====================================================================
+
+SizeHistogram::ThreadHistogram* SizeHistogram::get_thread_histogram() {
+    static thread_local ThreadHistogram* tls_histogram = nullptr;
+    if (tls_histogram == nullptr) {
+        ThreadHistogram* h = new ThreadHistogram();
+
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        h->next = registry_head_;
+        registry_head_ = h;
+        tls_histogram = h;
+    }
+    return tls_histogram;
+}
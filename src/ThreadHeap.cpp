@@ -1,7 +1,13 @@
 #include "gc_malloc/ThreadHeap.hpp"
 #include "gc_malloc/CentralHeap.hpp"
 #include "gc_malloc/PageGroup.hpp"
+#include "gc_malloc/HeapProfiler.hpp"
+#include "gc_malloc/TraceRecorder.hpp"
+#include "gc_malloc/SizeHistogram.hpp"
+#include "gc_malloc/MemoryLimit.hpp"
 #include <cassert>
+#include <cstdint>
+#include <chrono>
 
 
 // =====================================================================
@@ -12,6 +18,92 @@
 // 初始为 nullptr，在第一次分配时创建。
 thread_local ThreadHeap* ThreadHeap::tls_instance_ = nullptr;
 
+// 所有 ThreadHeap 组成的全局注册表，供统计等需要遍历全部线程的功能使用。
+std::mutex ThreadHeap::registry_mutex_;
+ThreadHeap* ThreadHeap::registry_head_ = nullptr;
+
+// 尚未退出的线程数，用于均分线程缓存的总预算
+std::atomic<size_t> ThreadHeap::active_threads_{0};
+
+// 各线程公布的缓存字节数之和，超过总预算时请求所有线程 trim
+std::atomic<size_t> ThreadHeap::total_cached_bytes_{0};
+
+// epoch 回收的全局 epoch，0 保留给“不在临界区”
+std::atomic<uint64_t> ThreadHeap::global_epoch_{1};
+
+// 线程退出时归还缓存。ThreadHeap 本身不销毁，仍在使用的块照常由其他线程释放。
+struct ThreadHeapExitGuard {
+    ThreadHeap* heap = nullptr;
+    ~ThreadHeapExitGuard();
+};
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// CentralHeap 只在整个 Region 空闲时 munmap，零散的空闲 span 会一直驻留。
+// 衰减周期与 trim 结束时，未归还的空闲页超过阈值就 madvise 归还，
+// 负载尖峰过后即使有零散的幸存对象，RSS 也能回落
+static void release_central_free_pages() {
+    CentralHeap& central = CentralHeap::GetInstance();
+    if (central.unreleased_free_bytes() > ThreadHeap::kFreePagesReleaseBytes) {
+        central.release_free_memory();
+    }
+}
+
+// 一次 refill 切分出的块数
+static size_t blocks_per_group(size_t index) {
+    return SizeClassInfo::get_pages_to_acquire_for_index(index) * CentralHeap::kPageSize /
+           SizeClassInfo::get_block_size_for_index(index);
+}
+
+// 每个类别的 partial/empty PageGroup 链表是双向链表，插入和摘除都是 O(1)
+static void push_group(PageGroup** head, PageGroup* group) {
+    group->prev_in_class_list = nullptr;
+    group->next_in_class_list = *head;
+    if (*head != nullptr) {
+        (*head)->prev_in_class_list = group;
+    }
+    *head = group;
+}
+
+static void remove_group(PageGroup** head, PageGroup* group) {
+    if (group->prev_in_class_list != nullptr) {
+        group->prev_in_class_list->next_in_class_list = group->next_in_class_list;
+    } else {
+        assert(*head == group);
+        *head = group->next_in_class_list;
+    }
+    if (group->next_in_class_list != nullptr) {
+        group->next_in_class_list->prev_in_class_list = group->prev_in_class_list;
+    }
+    group->prev_in_class_list = nullptr;
+    group->next_in_class_list = nullptr;
+}
+
+// 空闲链表为空且所有块都已切分，组内没有可分配的块
+static bool group_is_full(const PageGroup* group) {
+    return group->free_list == nullptr && group->carved_block_count == group->total_block_count;
+}
+
+// 组的占用率桶号，满组不在任何桶中，因此结果总小于 kOccupancyBuckets
+static size_t occupancy_bucket(int in_used, int total) {
+    return static_cast<size_t>(in_used) * ThreadHeap::kOccupancyBuckets / static_cast<size_t>(total);
+}
+
+static void link_partial(PageGroup** buckets, uint32_t* mask, PageGroup* group, size_t bucket) {
+    push_group(&buckets[bucket], group);
+    *mask |= 1u << bucket;
+}
+
+static void unlink_partial(PageGroup** buckets, uint32_t* mask, PageGroup* group, size_t bucket) {
+    remove_group(&buckets[bucket], group);
+    if (buckets[bucket] == nullptr) {
+        *mask &= ~(1u << bucket);
+    }
+}
+
 
 
 // =====================================================================
@@ -34,127 +126,514 @@ ThreadHeap* ThreadHeap::GetInstance() {
         // 使用 new 创建，因为它的生命周期需要由我们手动管理
         // (虽然我们在这个设计中没有手动 delete，依赖进程退出)
         tls_instance_ = new ThreadHeap();
+
+        // 以实例地址作为随机种子，保证各线程的采样序列互不相同
+        tls_instance_->sample_rng_state_ = reinterpret_cast<uintptr_t>(tls_instance_) | 1;
+        tls_instance_->bytes_until_sample_ =
+            HeapProfiler::GetInstance().next_sample_distance(&tls_instance_->sample_rng_state_);
+        tls_instance_->pressure_generation_seen_ = MemoryLimit::pressure_generation();
+
+        // 记录线程栈的范围，保守式回收需要扫描它
+        tls_instance_->thread_ = pthread_self();
+        pthread_attr_t attr;
+        if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+            void* stack_addr = nullptr;
+            size_t stack_size = 0;
+            if (pthread_attr_getstack(&attr, &stack_addr, &stack_size) == 0) {
+                tls_instance_->stack_base_ = static_cast<char*>(stack_addr) + stack_size;
+            }
+            pthread_attr_destroy(&attr);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            tls_instance_->next_in_registry_ = registry_head_;
+            registry_head_ = tls_instance_;
+        }
+        active_threads_.fetch_add(1, std::memory_order_relaxed);
+
+        static thread_local ThreadHeapExitGuard exit_guard;
+        exit_guard.heap = tls_instance_;
     }
     return tls_instance_;
 }
 
 
+// 小对象分配路径：从 current 组取块，用完后再按占用率挑选下一个组
+inline BlockHeader* ThreadHeap::take_block(size_t index) {
+    ClassCache& cache = class_caches_[index];
+    PageGroup* group = cache.current;
+    if (__builtin_expect(group == nullptr, 0)) {
+        group = select_group(index);
+        if (group == nullptr) {
+            return nullptr;
+        }
+    }
+    assert(!group_is_full(group));
+
+    BlockHeader* block = group->free_list;
+    if (block != nullptr) {
+        group->free_list = block->next;
+    } else {
+        // 按需从组内尚未切分的部分取下一块，只在此时写入它的头部
+        block = reinterpret_cast<BlockHeader*>(
+            static_cast<char*>(group->start_address) + group->color_offset +
+            group->carved_block_count * group->block_size);
+        block->owner_group = group;
+        group->carved_block_count++;
+    }
+    group->block_in_used_count++;
+    if (group_is_full(group)) {
+        // 组内的块已全部分配，等 GC 回收块时再挂回 partial 链表
+        cache.current = nullptr;
+    }
+
+    cache.count--;
+    if (cache.count < cache.low_water) {
+        cache.low_water = cache.count;
+    }
+    return block;
+}
+
+
+// 把新分配的块挂入年轻代
+inline void ThreadHeap::link_managed(BlockHeader* block) {
+    block->state = STATE_IN_USE;
+    block->next = young_lists_[0];
+    // 保守式回收会在任意位置挂起本线程并遍历托管链表，
+    // 块的头部必须在挂入链表之前写完
+    std::atomic_signal_fence(std::memory_order_release);
+    young_lists_[0] = block;
+}
+
+
 void* ThreadHeap::allocate(size_t size) {
-    const size_t index = SizeClassInfo::map_size_to_index(size);
+    // 加上头部并按页向上取整后不能回绕，否则会映射到很小的块
+    if (__builtin_expect(size > SIZE_MAX - sizeof(BlockHeader) - CentralHeap::kPageSize, 0)) {
+        return nullptr;
+    }
+    // 块大小包含 BlockHeader，用户可用空间从头部之后开始
+    const size_t index = SizeClassInfo::map_size_to_index(size + sizeof(BlockHeader));
     BlockHeader* block_to_alloc = nullptr;
 
     if (index < kNumSizeClasses) {
-        // 小对象分配路径
-        if (free_lists_[index].head == nullptr) {
-            if (!refill(index)) {
-                return nullptr;
-            }
+        block_to_alloc = take_block(index);
+        if (block_to_alloc == nullptr) {
+            return nullptr;
         }
-        assert(free_lists_[index].head != nullptr);
-        
-        block_to_alloc = free_lists_[index].head;
-        free_lists_[index].head = block_to_alloc->next;
-        free_lists_[index].count--;
-        block_to_alloc->owner_group->block_in_used_count++;
+        counters_.alloc_count[index].add(1);
     } else {
         // 大对象分配路径
         const size_t total_size_needed = size + sizeof(BlockHeader);
         const size_t num_pages = (total_size_needed + CentralHeap::kPageSize - 1) / CentralHeap::kPageSize;
 
-        PageGroup* group = request_pages_from_central_heap(num_pages);
+        on_allocation_slow_path();
+        // 复用的 span 可能比需要的略大，page_count 始终是它的实际页数
+        PageGroup* group = take_cached_span(num_pages);
         if (group == nullptr) {
-            return nullptr;
+            group = request_pages_from_central_heap(num_pages);
+            if (group == nullptr) {
+                return nullptr;
+            }
         }
 
         block_to_alloc = static_cast<BlockHeader*>(group->start_address);
         block_to_alloc->owner_group = group;
-        group->page_count = num_pages;
         group->block_size = total_size_needed;
         group->total_block_count = 1;
         group->block_in_used_count = 1;
+
+        counters_.large_alloc_count.add(1);
+        counters_.large_alloc_bytes.add(group->page_count * CentralHeap::kPageSize);
     }
 
     // 统一处理头部并链接到托管链表
-    block_to_alloc->state = STATE_IN_USE;
-    block_to_alloc->next = managed_list_head_;
-    managed_list_head_ = block_to_alloc;
+    link_managed(block_to_alloc);
+
+    // 采样关闭时这里只有一次比较和一次减法
+    if (__builtin_expect(size >= bytes_until_sample_, 0)) {
+        sample_allocation(block_to_alloc, size);
+    } else {
+        bytes_until_sample_ -= size;
+    }
+
+    if (TraceRecorder::enabled()) {
+        TraceRecorder::GetInstance().record(TRACE_ALLOCATE, block_to_alloc + 1, size);
+    }
+
+    if (SizeHistogram::enabled()) {
+        SizeHistogram::record(size);
+    }
 
     return static_cast<void*>(block_to_alloc + 1);
 }
 
+size_t ThreadHeap::allocate_batch(size_t index, void** out, size_t count) {
+    assert(index < kNumSizeClasses);
+    size_t n = 0;
+    for (; n < count; ++n) {
+        BlockHeader* block = take_block(index);
+        if (block == nullptr) {
+            break;
+        }
+        link_managed(block);
+        out[n] = block + 1;
+    }
+    counters_.alloc_count[index].add(n);
+
+    // 这些块之后由 deallocate 释放并照常记录，这里也要记下分配，
+    // 大小取块的可用大小
+    if (TraceRecorder::enabled()) {
+        const size_t usable = SizeClassInfo::get_block_size_for_index(index) - sizeof(BlockHeader);
+        for (size_t i = 0; i < n; ++i) {
+            TraceRecorder::GetInstance().record(TRACE_ALLOCATE, out[i], usable);
+        }
+    }
+    return n;
+}
+
+
 void ThreadHeap::deallocate(void* ptr) {
     if (ptr == nullptr) {
         return;
     }
+    // 必须在标记释放之前记录，否则所属线程可能先回收并重新分配该地址，
+    // 使 trace 中出现同一地址“先分配后释放”的错序
+    if (TraceRecorder::enabled()) {
+        TraceRecorder::GetInstance().record(TRACE_FREE, ptr, 0);
+    }
+
     BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    if (atomic_load_relaxed(&header->state) == STATE_IN_USE_OLD) {
+        // 老年代不会被每次扫描访问，需要告诉所属线程其中出现了垃圾
+        header->owner_group->owner_heap->old_frees_.fetch_add(1, std::memory_order_relaxed);
+    }
     atomic_store_release(&header->state, STATE_FREED);
 }
 
 
+void ThreadHeap::deallocate(void* ptr, size_t size) {
+    assert(ptr == nullptr ||
+           (static_cast<BlockHeader*>(ptr) - 1)->owner_group->block_size >= size + sizeof(BlockHeader));
+    (void)size;
+    deallocate(ptr);
+}
+
+
+void ThreadHeap::retire(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (TraceRecorder::enabled()) {
+        TraceRecorder::GetInstance().record(TRACE_FREE, ptr, 0);
+    }
+
+    // 调用者已经把块从共享结构中摘下。seq_cst 读保证：读到的 epoch 之后进入
+    // 临界区的线程都不可能再看到这个块
+    const uint64_t epoch = global_epoch_.load(std::memory_order_seq_cst);
+    BlockHeader* header = static_cast<BlockHeader*>(ptr) - 1;
+    if (atomic_load_relaxed(&header->state) == STATE_IN_USE_OLD) {
+        header->owner_group->owner_heap->old_frees_.fetch_add(1, std::memory_order_relaxed);
+    }
+    atomic_store_release(&header->state, make_retired_state(epoch));
+}
+
+
 void ThreadHeap::garbage_collect() {
-    BlockHeader* current = managed_list_head_;
+    if (TraceRecorder::enabled()) {
+        TraceRecorder::GetInstance().record(TRACE_COLLECT, nullptr, 0);
+    }
+    sweep(should_sweep_old());
+}
+
+
+void ThreadHeap::sweep(bool include_old) {
+    const auto gc_start = std::chrono::steady_clock::now();
+    size_t visited_blocks = 0;
+    size_t reclaimed_blocks = 0;
+    sweep_safe_epoch_ = 0;
+
+    if (include_old) {
+        // 先扫描老年代，再把新晋升的块接到它前面，避免它们被重复访问
+        old_frees_.store(0, std::memory_order_relaxed);
+        size_t old_reclaimed = 0;
+        size_t old_retired = 0;
+        sweep_list(old_list_head_, false, &visited_blocks, &old_reclaimed, &old_retired);
+        // 还不能回收的 retired 块留到下一次老年代扫描
+        old_frees_.fetch_add(old_retired, std::memory_order_relaxed);
+        old_block_count_ -= old_reclaimed;
+        reclaimed_blocks += old_reclaimed;
+        sweeps_since_old_ = 0;
+        counters_.gc_old_sweeps.add(1);
+    } else {
+        sweeps_since_old_++;
+    }
+
+    // 从最老的年轻代开始，使每个链表的存活者整体移入已经清空的下一个链表
+    for (size_t age = kPromotionAge; age-- > 0;) {
+        const bool promote = age + 1 == kPromotionAge;
+        size_t reclaimed = 0;
+        size_t retired = 0;
+        const size_t visited_before = visited_blocks;
+        BlockHeader* tail = sweep_list(young_lists_[age], promote, &visited_blocks, &reclaimed, &retired);
+        reclaimed_blocks += reclaimed;
+        if (tail == nullptr) {
+            continue;
+        }
+        if (promote) {
+            const size_t promoted = visited_blocks - visited_before - reclaimed;
+            old_block_count_ += promoted;
+            old_frees_.fetch_add(retired, std::memory_order_relaxed);
+            counters_.gc_promoted_blocks.add(promoted);
+            splice_list(young_lists_[age], tail, old_list_head_);
+        } else {
+            splice_list(young_lists_[age], tail, young_lists_[age + 1]);
+        }
+    }
+
+    // 空闲的 PageGroup 统一在扫描结束后按上限批量归还
+    retire_current_groups();
+    enforce_cache_limits();
+    const auto gc_end = std::chrono::steady_clock::now();
+    decay_idle_cache(std::chrono::duration_cast<std::chrono::nanoseconds>(gc_end.time_since_epoch()).count());
+
+    publish_cached_bytes();
+
+    const auto gc_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(gc_end - gc_start).count();
+    counters_.gc_count.add(1);
+    counters_.gc_total_ns.add(gc_ns);
+    counters_.gc_max_ns.set_max(gc_ns);
+    counters_.gc_reclaimed_blocks.add(reclaimed_blocks);
+    counters_.gc_swept_blocks.add(visited_blocks);
+}
+
+
+bool ThreadHeap::should_sweep_old() const {
+    if (old_list_head_ == nullptr) {
+        return false;
+    }
+    // 释放与晋升并发时计数可能漏记，因此还要定期无条件扫描一次
+    if (sweeps_since_old_ + 1 >= kOldSweepInterval) {
+        return true;
+    }
+    const size_t old_frees = old_frees_.load(std::memory_order_relaxed);
+    return old_frees > 0 && old_frees * kOldGarbageRatio >= old_block_count_;
+}
+
+
+// 回收链表中所有已释放的块，返回剩余链表的尾节点（链表为空时返回 nullptr）。
+// promote 为 true 时，把存活的块标记为老年代。retired 累计尚不能回收的 retired 块数。
+BlockHeader* ThreadHeap::sweep_list(BlockHeader*& head, bool promote, size_t* visited, size_t* reclaimed,
+                                    size_t* retired) {
+    BlockHeader* current = head;
     BlockHeader* prev = nullptr;
 
     while (current != nullptr) {
         BlockHeader* next = current->next;
+        (*visited)++;
+
+        bool freed = false;
+        for (;;) {
+            const uintptr_t state = atomic_load_acquire(&current->state);
+            if (state == STATE_FREED) {
+                freed = true;
+            } else if (state_is_retired(state)) {
+                freed = retired_block_is_safe(state);
+                if (!freed) {
+                    (*retired)++;
+                }
+            } else if (promote && state == STATE_IN_USE &&
+                       !atomic_compare_exchange(&current->state, STATE_IN_USE, STATE_IN_USE_OLD)) {
+                // 晋升的同时块被其他线程释放或 retire，按新状态重新判断
+                continue;
+            }
+            break;
+        }
 
-        if (atomic_load_acquire(&current->state) == STATE_FREED) {
+        if (freed) {
             // 从托管链表中移除
             if (prev == nullptr) {
-                managed_list_head_ = next;
+                head = next;
             } else {
                 prev->next = next;
             }
-
-            PageGroup* owner_group = current->owner_group;
-            assert(owner_group != nullptr);
-
-            if (owner_group->block_size > 0) {
-                // 回收小对象
-                const size_t index = SizeClassInfo::map_size_to_index(owner_group->block_size);
-                current->next = free_lists_[index].head;
-                free_lists_[index].head = current;
-                free_lists_[index].count++;
-
-                owner_group->block_in_used_count--;
-                               if (owner_group->block_in_used_count == 0 && 
-                    free_lists_[index].count > owner_group->total_block_count) {
-
-                    FreeList& list = free_lists_[index];
-                    BlockHeader** indirect_head = &list.head;
-                    size_t removed_count = 0;
-
-                    while (*indirect_head != nullptr) {
-                        if ((*indirect_head)->owner_group == owner_group) {
-                            *indirect_head = (*indirect_head)->next;
-                            removed_count++;
-                        } else {
-                            indirect_head = &((*indirect_head)->next);
-                        }
-                    }
-                    list.count -= removed_count;
-                    
-                    release_pages_to_central_heap(owner_group);
-                }
-            } else {
-                // 回收大对象
-                release_pages_to_central_heap(owner_group);
-            }
-            current = next;
+            std::atomic_signal_fence(std::memory_order_release);
+            reclaim_block(current);
+            (*reclaimed)++;
         } else {
             prev = current;
-            current = next;
+        }
+        current = next;
+    }
+    return prev;
+}
+
+
+void ThreadHeap::reclaim_block(BlockHeader* block) {
+    PageGroup* owner_group = block->owner_group;
+    assert(owner_group != nullptr);
+
+    if (owner_group->sampled_block_count > 0 &&
+        HeapProfiler::GetInstance().record_free(block + 1)) {
+        owner_group->sampled_block_count--;
+    }
+
+    // 大对象的 block_size 是 size + 头部大小，会超出所有尺寸类别，
+    // 因此用映射结果区分大小对象，避免越界访问 class_caches_。
+    const size_t index = SizeClassInfo::map_size_to_index(owner_group->block_size);
+    if (index < kNumSizeClasses) {
+        // 回收小对象
+        recycle_block(index, block);
+        counters_.free_count[index].add(1);
+    } else {
+        // 回收大对象
+        counters_.large_free_count.add(1);
+        counters_.large_free_bytes.add(owner_group->page_count * CentralHeap::kPageSize);
+        cache_large_span(owner_group);
+    }
+}
+
+
+// 在大对象 span 缓存中找页数在 [num_pages, num_pages + num_pages / kLargeCacheSlack]
+// 之间的最小者，页数相同时取最近放入的
+PageGroup* ThreadHeap::take_cached_span(size_t num_pages) {
+    const size_t max_pages = num_pages + num_pages / kLargeCacheSlack;
+    PageGroup* best = nullptr;
+    for (PageGroup* group = large_cache_; group != nullptr; group = group->next_in_class_list) {
+        if (group->page_count >= num_pages && group->page_count <= max_pages &&
+            (best == nullptr || group->page_count < best->page_count)) {
+            best = group;
+            if (best->page_count == num_pages) {
+                break;
+            }
+        }
+    }
+    if (best == nullptr) {
+        return nullptr;
+    }
+
+    remove_group(&large_cache_, best);
+    large_cache_bytes_ -= best->page_count * CentralHeap::kPageSize;
+    if (large_cache_bytes_ < large_cache_low_water_) {
+        large_cache_low_water_ = large_cache_bytes_;
+    }
+    counters_.large_cache_hits.add(1);
+    return best;
+}
+
+
+void ThreadHeap::cache_large_span(PageGroup* group) {
+    group->block_in_used_count = 0;
+    const size_t bytes = group->page_count * CentralHeap::kPageSize;
+    // 线程很多时预算会降到下限，大对象缓存随之收缩
+    const size_t budget = thread_cache_budget();
+    const size_t limit = budget < kLargeCacheBytes ? budget : kLargeCacheBytes;
+    if (bytes > limit) {
+        release_pages_to_central_heap(group);
+        return;
+    }
+    push_group(&large_cache_, group);
+    large_cache_bytes_ += bytes;
+    release_large_cache(limit);
+}
+
+
+// 从表尾（最早放入的）开始归还，直到缓存不超过 target_bytes
+void ThreadHeap::release_large_cache(size_t target_bytes) {
+    if (large_cache_bytes_ <= target_bytes) {
+        return;
+    }
+    PageGroup* tail = large_cache_;
+    while (tail->next_in_class_list != nullptr) {
+        tail = tail->next_in_class_list;
+    }
+    while (large_cache_bytes_ > target_bytes) {
+        PageGroup* prev = tail->prev_in_class_list;
+        remove_group(&large_cache_, tail);
+        large_cache_bytes_ -= tail->page_count * CentralHeap::kPageSize;
+        release_pages_to_central_heap(tail);
+        tail = prev;
+    }
+    if (large_cache_bytes_ < large_cache_low_water_) {
+        large_cache_low_water_ = large_cache_bytes_;
+    }
+}
+
+
+// retired 块的 epoch 比全局 epoch 至少落后 2 时才能回收。只有遇到 retired 块
+// 才需要遍历注册表尝试推进全局 epoch，每次扫描最多一次。
+bool ThreadHeap::retired_block_is_safe(uintptr_t state) {
+    if (sweep_safe_epoch_ == 0) {
+        sweep_safe_epoch_ = try_advance_epoch();
+    }
+    return retired_epoch(state) + 2 <= sweep_safe_epoch_;
+}
+
+
+// 所有处于临界区的线程都已观察到当前全局 epoch 时把它加一，返回推进后的值
+uint64_t ThreadHeap::try_advance_epoch() {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    uint64_t epoch = global_epoch_.load(std::memory_order_seq_cst);
+    for (ThreadHeap* heap = registry_head_; heap != nullptr; heap = heap->next_in_registry_) {
+        const uint64_t active = heap->active_epoch_.load(std::memory_order_seq_cst);
+        if (active != 0 && active != epoch) {
+            return epoch;
         }
     }
+    if (global_epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) {
+        return epoch + 1;
+    }
+    return epoch;
+}
+
+
+// 把 from 整条链表（尾节点为 tail）接到 to 的前面。
+// 保守式回收可能在任意一步挂起本线程，因此每一步都保证所有块至少能从
+// 一个链表头到达；中间状态下同一个块可能出现在两个链表中，由回收器去重。
+void ThreadHeap::splice_list(BlockHeader*& from, BlockHeader* tail, BlockHeader*& to) {
+    tail->next = to;
+    std::atomic_signal_fence(std::memory_order_release);
+    to = from;
+    std::atomic_signal_fence(std::memory_order_release);
+    from = nullptr;
+}
+
+// trim 不写入 trace：回放时每个线程退出也会各自 trim 一次
+void ThreadHeap::trim() {
+    sweep(true);
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        release_empty_groups(i, 0);
+    }
+    release_large_cache(0);
+    publish_cached_bytes();
+    release_central_free_pages();
+}
+
+
+size_t ThreadHeap::cached_bytes() const {
+    size_t bytes = large_cache_bytes_;
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        bytes += class_caches_[i].count * SizeClassInfo::get_block_size_for_index(i);
+    }
+    return bytes;
+}
+
+
+size_t ThreadHeap::thread_cache_budget() {
+    const size_t threads = active_threads_.load(std::memory_order_relaxed);
+    const size_t share = kOverallCacheBytes / (threads == 0 ? 1 : threads);
+    return share > kMinThreadCacheBytes ? share : kMinThreadCacheBytes;
 }
 
+
 // =====================================================================
 // 私有辅助函数实现 (Private Helper Implementation)
 // =====================================================================
 
 bool ThreadHeap::refill(size_t index) {
     assert(index < kNumSizeClasses);
-    assert(free_lists_[index].head == nullptr);
+    assert(class_caches_[index].current == nullptr && class_caches_[index].partial_mask == 0 &&
+           class_caches_[index].empty == nullptr);
 
     const size_t num_pages_to_acquire = SizeClassInfo::get_pages_to_acquire_for_index(index);
     const size_t block_size = SizeClassInfo::get_block_size_for_index(index);
@@ -168,38 +647,318 @@ bool ThreadHeap::refill(size_t index) {
     group->block_size = block_size;
     group->page_count = num_pages_to_acquire;
     
-    char* start = static_cast<char*>(group->start_address);
     const size_t total_bytes = group->page_count * CentralHeap::kPageSize;
     const size_t num_blocks = total_bytes / block_size;
     
     group->total_block_count = num_blocks;
     group->block_in_used_count = 0;
 
-    BlockHeader* current_list_head = nullptr;
-    for (size_t i = 0; i < num_blocks; ++i) {
-        char* block_start = start + i * block_size;
-        BlockHeader* header = reinterpret_cast<BlockHeader*>(block_start);
-        
-        header->state = STATE_FREED; // 新块初始为空闲
-        header->owner_group = group;
+    ClassCache& cache = class_caches_[index];
+
+    // 缓存着色：各组的第一个块都在页首时会落在相同的缓存组上。
+    // 用切分后剩余的尾部空间，让每个新组的起始偏移依次错开一条缓存行
+    const size_t num_colors = (total_bytes - num_blocks * block_size) / kCacheLineSize + 1;
+    group->color_offset = (cache.next_color++ % num_colors) * kCacheLineSize;
+
+    // 不在这里串联空闲块：块在第一次分配时才切分，
+    // 从未用到的尾部页面不会被访问，也就不会产生缺页
+    group->free_list = nullptr;
+    group->carved_block_count = 0;
 
-        // 利用 next 临时串联空闲块
-        header->next = current_list_head;
-        current_list_head = header;
+    cache.current = group;
+    cache.count += num_blocks;
+
+    // 缓存被用空才会 refill，说明当前上限跟不上需求
+    const size_t class_limit = kMaxClassCacheBytes / block_size;
+    if (cache.max_count < num_blocks) {
+        cache.max_count = num_blocks;
+    } else if (cache.max_count + num_blocks <= class_limit) {
+        cache.max_count += num_blocks;
     }
 
-    free_lists_[index].head = current_list_head;
-    free_lists_[index].count = num_blocks;
+    counters_.refill_count[index].add(1);
+    counters_.refill_blocks[index].add(num_blocks);
 
     return true;
 }
 
 
 
+void ThreadHeap::sample_allocation(BlockHeader* block, size_t size) {
+    HeapProfiler& profiler = HeapProfiler::GetInstance();
+    bytes_until_sample_ = profiler.next_sample_distance(&sample_rng_state_);
+
+    if (profiler.sample_period() == 0) {
+        return;
+    }
+
+    profiler.record_allocation(block + 1, size);
+    block->owner_group->sampled_block_count++;
+}
+
+
 PageGroup* ThreadHeap::request_pages_from_central_heap(size_t num_pages) {
-    return CentralHeap::GetInstance().acquire_pages(num_pages);
+    PageGroup* group = CentralHeap::GetInstance().acquire_pages(num_pages);
+    if (group != nullptr) {
+        group->owner_heap = this;
+    }
+    return group;
 }
 
 void ThreadHeap::release_pages_to_central_heap(PageGroup* group) {
     CentralHeap::GetInstance().release_pages(group);
 }
+
+
+// =====================================================================
+// 缓存容量控制 (Cache Size Control)
+// =====================================================================
+
+// GC 回收的小对象块放回所属 PageGroup，并按组的新状态调整它所在的链表
+void ThreadHeap::recycle_block(size_t index, BlockHeader* block) {
+    ClassCache& cache = class_caches_[index];
+    PageGroup* group = block->owner_group;
+    const bool was_full = group_is_full(group);
+
+    block->next = group->free_list;
+    group->free_list = block;
+    group->block_in_used_count--;
+    cache.count++;
+
+    if (group == cache.current) {
+        return;
+    }
+    if (was_full) {
+        if (group->block_in_used_count == 0) {
+            push_group(&cache.empty, group);
+        } else {
+            link_partial(cache.partial, &cache.partial_mask, group,
+                         occupancy_bucket(group->block_in_used_count, group->total_block_count));
+        }
+        return;
+    }
+
+    const size_t old_bucket = occupancy_bucket(group->block_in_used_count + 1, group->total_block_count);
+    if (group->block_in_used_count == 0) {
+        unlink_partial(cache.partial, &cache.partial_mask, group, old_bucket);
+        push_group(&cache.empty, group);
+        return;
+    }
+    const size_t new_bucket = occupancy_bucket(group->block_in_used_count, group->total_block_count);
+    if (new_bucket != old_bucket) {
+        unlink_partial(cache.partial, &cache.partial_mask, group, old_bucket);
+        link_partial(cache.partial, &cache.partial_mask, group, new_bucket);
+    }
+}
+
+
+// current 用完时挑选下一个分配用的组：占用率最高的 partial 组优先，
+// 其次是 empty 组，都没有时才向 CentralHeap refill
+PageGroup* ThreadHeap::select_group(size_t index) {
+    ClassCache& cache = class_caches_[index];
+    assert(cache.current == nullptr);
+
+    on_allocation_slow_path();
+
+    PageGroup* group;
+    if (cache.partial_mask != 0) {
+        const size_t bucket = 31 - __builtin_clz(cache.partial_mask);
+        group = cache.partial[bucket];
+        unlink_partial(cache.partial, &cache.partial_mask, group, bucket);
+    } else if (cache.empty != nullptr) {
+        group = cache.empty;
+        remove_group(&cache.empty, group);
+    } else {
+        return refill(index) ? cache.current : nullptr;
+    }
+
+    cache.current = group;
+    return group;
+}
+
+
+// 分配慢路径上的周期性工作：先响应内存压力与其他线程的 trim 请求，否则按
+// 时间戳检查空闲衰减，只分配而从不调用 garbage_collect 的线程缓存也会衰减
+void ThreadHeap::on_allocation_slow_path() {
+    if (__builtin_expect(memory_pressure_pending(), 0)) {
+        relieve_memory_pressure();
+        return;
+    }
+    const uint64_t now = now_ns();
+    if (now - last_decay_ns_ >= kDecayIntervalNs) {
+        decay_idle_cache(now);
+        publish_cached_bytes();
+    }
+}
+
+
+// 把本线程缓存的变化计入全局总量。总量超过总预算、且本线程还没有为当前
+// 压力代数请求过时，递增压力代数，其他线程在各自的慢路径上 trim
+void ThreadHeap::publish_cached_bytes() {
+    const size_t bytes = cached_bytes();
+    if (bytes == published_cached_bytes_) {
+        return;
+    }
+    size_t total;
+    if (bytes > published_cached_bytes_) {
+        total = total_cached_bytes_.fetch_add(bytes - published_cached_bytes_, std::memory_order_relaxed) +
+                (bytes - published_cached_bytes_);
+    } else {
+        total = total_cached_bytes_.fetch_sub(published_cached_bytes_ - bytes, std::memory_order_relaxed) -
+                (published_cached_bytes_ - bytes);
+    }
+    published_cached_bytes_ = bytes;
+
+    if (total > kOverallCacheBytes && pressure_generation_seen_ == MemoryLimit::pressure_generation()) {
+        MemoryLimit::request_trim();
+        // 本线程刚按预算整理过缓存，不必响应自己的请求
+        pressure_generation_seen_ = MemoryLimit::pressure_generation();
+    }
+}
+
+
+bool ThreadHeap::memory_pressure_pending() const {
+    return pressure_generation_seen_ != MemoryLimit::pressure_generation() || MemoryLimit::over_threshold();
+}
+
+
+// 先回收本线程的缓存，仍超过阈值时再由 MemoryLimit 通知其他线程、
+// 归还 CentralHeap 的空闲内存，必要时调用硬上限回调
+void ThreadHeap::relieve_memory_pressure() {
+    trim();
+    if (MemoryLimit::over_threshold()) {
+        MemoryLimit::GetInstance().relieve_pressure();
+    }
+    pressure_generation_seen_ = MemoryLimit::pressure_generation();
+}
+
+
+// GC 之后 current 组可能已经变空，或者有了占用率更高的 partial 组。
+// 此时把 current 放回对应链表，下一次分配重新挑选，空组也因此可以被归还。
+void ThreadHeap::retire_current_groups() {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        ClassCache& cache = class_caches_[i];
+        PageGroup* group = cache.current;
+        if (group == nullptr) {
+            continue;
+        }
+
+        if (group->block_in_used_count == 0) {
+            push_group(&cache.empty, group);
+            cache.current = nullptr;
+            continue;
+        }
+        const size_t bucket = occupancy_bucket(group->block_in_used_count, group->total_block_count);
+        if ((cache.partial_mask >> (bucket + 1)) != 0) {
+            link_partial(cache.partial, &cache.partial_mask, group, bucket);
+            cache.current = nullptr;
+        }
+    }
+}
+
+
+// 从 empty 链表摘下 PageGroup 归还，直到缓存块数不超过 target_count。
+// partial 链表中的组仍有块在使用，不能归还，因此结果可能仍高于目标，
+// 也可能因为按整组归还而略低于目标。
+size_t ThreadHeap::release_empty_groups(size_t index, size_t target_count) {
+    ClassCache& cache = class_caches_[index];
+    size_t released = 0;
+
+    while (cache.count > target_count && cache.empty != nullptr) {
+        PageGroup* group = cache.empty;
+        remove_group(&cache.empty, group);
+        cache.count -= group->total_block_count;
+        released += group->total_block_count;
+        release_pages_to_central_heap(group);
+    }
+
+    if (released > 0) {
+        counters_.released_blocks[index].add(released);
+    }
+    if (cache.count < cache.low_water) {
+        cache.low_water = cache.count;
+    }
+    return released;
+}
+
+
+void ThreadHeap::enforce_cache_limits() {
+    // 1. 各类别的自适应上限
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        ClassCache& cache = class_caches_[i];
+        if (cache.count <= cache.max_count) {
+            continue;
+        }
+        release_empty_groups(i, cache.max_count);
+
+        // 频繁超限说明上限高于实际需求，收缩一个 PageGroup 的量
+        if (++cache.overages > kMaxOverages) {
+            const size_t group_blocks = blocks_per_group(i);
+            cache.max_count = cache.max_count > 2 * group_blocks ? cache.max_count - group_blocks : group_blocks;
+            cache.overages = 0;
+        }
+    }
+
+    // 2. 线程总预算：先淘汰大对象 span，再从大块类别开始归还，直到低于预算
+    const size_t budget = thread_cache_budget();
+    size_t bytes = cached_bytes();
+    if (bytes > budget) {
+        const size_t excess = bytes - budget;
+        release_large_cache(large_cache_bytes_ > excess ? large_cache_bytes_ - excess : 0);
+        bytes = cached_bytes();
+    }
+    for (size_t i = kNumSizeClasses; i-- > 0 && bytes > budget;) {
+        const size_t block_size = SizeClassInfo::get_block_size_for_index(i);
+        const size_t excess_blocks = (bytes - budget + block_size - 1) / block_size;
+        const size_t count = class_caches_[i].count;
+        bytes -= release_empty_groups(i, count > excess_blocks ? count - excess_blocks : 0) * block_size;
+    }
+}
+
+
+// 每个衰减周期把整个周期都没用到的块（low_water）归还一半，
+// 长时间空闲的线程缓存会按指数衰减。
+void ThreadHeap::decay_idle_cache(uint64_t now_ns) {
+    if (now_ns - last_decay_ns_ < kDecayIntervalNs) {
+        return;
+    }
+    last_decay_ns_ = now_ns;
+
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        ClassCache& cache = class_caches_[i];
+        const size_t drop = cache.low_water / 2;
+        if (drop > 0) {
+            release_empty_groups(i, cache.count - drop);
+            const size_t group_blocks = blocks_per_group(i);
+            cache.max_count = cache.max_count > group_blocks + drop ? cache.max_count - drop : group_blocks;
+        }
+        cache.low_water = cache.count;
+    }
+
+    // 表尾的 span 最早放入，先归还它们
+    release_large_cache(large_cache_bytes_ - large_cache_low_water_ / 2);
+    large_cache_low_water_ = large_cache_bytes_;
+
+    release_central_free_pages();
+}
+
+
+void ThreadHeap::on_thread_exit() {
+    trim();
+    active_threads_.fetch_sub(1, std::memory_order_relaxed);
+
+    // 线程在临界区内退出时不能让全局 epoch 永远停住
+    critical_depth_ = 0;
+    active_epoch_.store(0, std::memory_order_release);
+
+    // 此后线程随时可能消失，保守式回收不能再向它发信号
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    thread_alive_ = false;
+}
+
+
+ThreadHeapExitGuard::~ThreadHeapExitGuard() {
+    if (heap != nullptr) {
+        heap->on_thread_exit();
+    }
+}
@@ -0,0 +1,157 @@
+#include "gc_malloc/TraceRecorder.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+
+
+std::atomic<bool> TraceRecorder::enabled_{false};
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// =====================================================================
+// 单例模式实现 (Singleton Implementation)
+// =====================================================================
+
+TraceRecorder& TraceRecorder::GetInstance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+
+// =====================================================================
+// 公共接口实现 (Public API Implementation)
+// =====================================================================
+
+bool TraceRecorder::start(const char* path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_ != nullptr) {
+        return false;
+    }
+
+    file_ = std::fopen(path, "wb");
+    if (file_ == nullptr) {
+        return false;
+    }
+
+    TraceFileHeader header;
+    std::memcpy(header.magic, "GCMTRACE", sizeof(header.magic));
+    header.version = kVersion;
+    header.record_size = sizeof(TraceRecord);
+    std::fwrite(&header, sizeof(header), 1, file_);
+
+    // 丢弃上一次会话残留在缓冲区中的记录
+    for (ThreadBuffer* b = buffers_; b != nullptr; b = b->next) {
+        std::lock_guard<std::mutex> buffer_lock(b->mutex);
+        b->count = 0;
+    }
+
+    start_ns_ = now_ns();
+    enabled_.store(true, std::memory_order_release);
+    return true;
+}
+
+
+void TraceRecorder::stop() {
+    enabled_.store(false, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_ == nullptr) {
+        return;
+    }
+
+    for (ThreadBuffer* b = buffers_; b != nullptr; b = b->next) {
+        std::lock_guard<std::mutex> buffer_lock(b->mutex);
+        flush_locked(b);
+    }
+
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+
+void TraceRecorder::record(TraceOp op, const void* ptr, size_t size) {
+    ThreadBuffer* buffer = get_thread_buffer();
+
+    TraceRecord rec;
+    rec.timestamp_ns = now_ns() - start_ns_;
+    rec.address = reinterpret_cast<uintptr_t>(ptr);
+    rec.size = size;
+    rec.thread_id = buffer->thread_id;
+    rec.op = op;
+    std::memset(rec.reserved, 0, sizeof(rec.reserved));
+
+    bool full;
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->records[buffer->count++] = rec;
+        full = buffer->count == kBufferRecords;
+    }
+
+    // 加锁顺序始终是 mutex_ -> buffer->mutex，与 stop() 保持一致
+    if (full) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        flush_locked(buffer);
+    }
+}
+
+
+bool TraceRecorder::read_trace(const char* path, std::vector<TraceRecord>* out) {
+    assert(out != nullptr);
+
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    TraceFileHeader header;
+    const bool header_ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                           std::memcmp(header.magic, "GCMTRACE", sizeof(header.magic)) == 0 &&
+                           header.version == kVersion &&
+                           header.record_size == sizeof(TraceRecord);
+    if (!header_ok) {
+        std::fclose(file);
+        return false;
+    }
+
+    out->clear();
+    TraceRecord batch[kBufferRecords];
+    size_t n;
+    while ((n = std::fread(batch, sizeof(TraceRecord), kBufferRecords, file)) > 0) {
+        out->insert(out->end(), batch, batch + n);
+    }
+    std::fclose(file);
+    return true;
+}
+
+
+// =====================================================================
+// 私有辅助函数实现 (Private Helper Implementation)
+// =====================================================================
+
+TraceRecorder::ThreadBuffer* TraceRecorder::get_thread_buffer() {
+    static thread_local ThreadBuffer* tls_buffer = nullptr;
+    if (tls_buffer == nullptr) {
+        ThreadBuffer* buffer = new ThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->thread_id = next_thread_id_++;
+        buffer->next = buffers_;
+        buffers_ = buffer;
+        tls_buffer = buffer;
+    }
+    return tls_buffer;
+}
+
+
+void TraceRecorder::flush_locked(ThreadBuffer* buffer) {
+    if (file_ != nullptr && buffer->count > 0) {
+        std::fwrite(buffer->records, sizeof(TraceRecord), buffer->count, file_);
+    }
+    buffer->count = 0;
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "gc_malloc/Arena.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+
+namespace {
+
+uint64_t central_pages_in_use() {
+    CentralHeap::Stats stats;
+    CentralHeap::GetInstance().collect_stats(&stats);
+    return stats.pages_in_use;
+}
+
+} // namespace
+
+// =====================================================================
+// 测试 1: 顺序分配满足对齐要求，且对象之间没有头部
+// =====================================================================
+TEST(ArenaTest, BumpAllocatesContiguouslyWithAlignment) {
+    Arena arena;
+
+    char* a = static_cast<char*>(arena.allocate(24, 8));
+    char* b = static_cast<char*>(arena.allocate(24, 8));
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(b, a + 24);
+
+    void* c = arena.allocate(1, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0u);
+
+    struct Point {
+        int x, y;
+        Point(int x_, int y_) : x(x_), y(y_) {}
+    };
+    Point* p = arena.create<Point>(3, 4);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(p->x + p->y, 7);
+    EXPECT_EQ(arena.held_pages(), Arena::kDefaultChunkPages);
+}
+
+// =====================================================================
+// 测试 2: reset 一次性归还除第一个 chunk 以外的全部 PageGroup
+// =====================================================================
+TEST(ArenaTest, ResetReturnsPageGroupsInBulk) {
+    const uint64_t baseline = central_pages_in_use();
+    Arena arena(4);
+
+    std::vector<char*> objects;
+    for (int i = 0; i < 10000; ++i) {
+        char* obj = static_cast<char*>(arena.allocate(48));
+        ASSERT_NE(obj, nullptr);
+        std::memset(obj, i & 0xFF, 48);
+        objects.push_back(obj);
+    }
+    // 超过 chunk 大小的对象单独占用一个 PageGroup
+    void* big = arena.allocate(64 * 1024);
+    ASSERT_NE(big, nullptr);
+    std::memset(big, 0, 64 * 1024);
+
+    EXPECT_GT(arena.held_pages(), 4u);
+    EXPECT_EQ(central_pages_in_use() - baseline, arena.held_pages());
+
+    arena.reset();
+    EXPECT_EQ(arena.held_pages(), 4u);
+    EXPECT_EQ(arena.allocated_bytes(), 0u);
+    EXPECT_EQ(central_pages_in_use() - baseline, 4u);
+
+    // 保留的 chunk 从头开始复用
+    EXPECT_EQ(arena.allocate(48), static_cast<void*>(objects[0]));
+}
+
+// =====================================================================
+// 测试 3: 析构归还所有页，过大的请求返回 nullptr
+// =====================================================================
+TEST(ArenaTest, DestructorReleasesEverything) {
+    const uint64_t baseline = central_pages_in_use();
+    {
+        Arena arena;
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_NE(arena.allocate(1000), nullptr);
+        }
+        EXPECT_EQ(arena.allocate(CentralHeap::kRegionSizeBytes + 1), nullptr);
+    }
+    EXPECT_EQ(central_pages_in_use(), baseline);
+}
+
+// =====================================================================
+// 测试 4: 巨大的请求不会让快路径回绕，空 Arena 上的 0 字节请求也能分配
+// =====================================================================
+TEST(ArenaTest, HugeAndZeroSizedRequests) {
+    Arena fresh;
+    void* empty = fresh.allocate(0);
+    EXPECT_NE(empty, nullptr);
+    EXPECT_EQ(fresh.allocated_bytes(), 0u);
+
+    Arena arena;
+    char* first = static_cast<char*>(arena.allocate(16));
+    ASSERT_NE(first, nullptr);
+    const size_t held = arena.held_pages();
+    EXPECT_EQ(arena.allocate(SIZE_MAX - 8), nullptr);
+    EXPECT_EQ(arena.allocate(SIZE_MAX / 2, 64), nullptr);
+    EXPECT_EQ(arena.held_pages(), held);
+    EXPECT_EQ(arena.allocated_bytes(), 16u);
+
+    // 游标没有被破坏，后续分配紧接着第一个对象
+    EXPECT_EQ(arena.allocate(16), first + 16);
+}
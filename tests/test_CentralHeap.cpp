@@ -4,6 +4,7 @@
 #include <numeric>
 #include <algorithm>
 #include <map>
+#include <cstring>
 
 #include "gc_malloc/CentralHeap.hpp"
 #include "gc_malloc/PageGroup.hpp"
@@ -204,4 +205,107 @@ TEST_F(CentralHeapBlackBoxTest, MultiThreadedStressAndContention) {
     // 验证2: 理想情况下，所有申请的页最终都应该被释放。
     // 这可以间接检查是否有内存泄漏或计数错误。
     EXPECT_EQ(total_acquired_pages.load(), total_released_pages.load()) << "The total number of acquired and released pages do not match, suggesting a leak or accounting error.";
-}
\ No newline at end of file
+}
+
+
+// =====================================================================
+// 测试 5: release_free_memory 归还保留的空闲 Region
+// =====================================================================
+TEST_F(CentralHeapBlackBoxTest, ReleaseFreeMemoryUnmapsIdleRegions) {
+    // 两个整 Region 都释放后，其中一个会被保留以避免反复 mmap
+    PageGroup* a = heap_.acquire_pages(CentralHeap::kMaxPages);
+    PageGroup* b = heap_.acquire_pages(CentralHeap::kMaxPages);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    heap_.release_pages(a);
+    heap_.release_pages(b);
+
+    const size_t mapped_before = heap_.mapped_bytes();
+    EXPECT_GE(heap_.release_free_memory(), CentralHeap::kRegionSizeBytes);
+    EXPECT_LE(heap_.mapped_bytes() + CentralHeap::kRegionSizeBytes, mapped_before);
+
+    // 归还之后仍然可以正常分配
+    PageGroup* c = heap_.acquire_pages(4);
+    ASSERT_NE(c, nullptr);
+    static_cast<char*>(c->start_address)[0] = 1;
+    heap_.release_pages(c);
+}
+
+
+// 2 MiB Region 的配置，可以放下默认配置放不下的 span
+struct LargeRegionHeapConfig {
+    static constexpr size_t kPageSize = 4 * 1024;
+    static constexpr size_t kPagesPerMmap = 512;
+};
+
+// 16 KiB 页、64 页一个 Region 的配置，用于验证几何参数全部来自 Config
+struct BigPageHeapConfig {
+    static constexpr size_t kPageSize = 16 * 1024;
+    static constexpr size_t kPagesPerMmap = 64;
+};
+
+// =====================================================================
+// 测试 6: 不同配置的页堆互相独立，几何参数在编译期确定
+// =====================================================================
+TEST_F(CentralHeapBlackBoxTest, ConfigurationsAreIndependentHeaps) {
+    using LargeHeap = BasicCentralHeap<LargeRegionHeapConfig>;
+    using BigPageHeap = BasicCentralHeap<BigPageHeapConfig>;
+    static_assert(LargeHeap::kRegionSizeBytes == 2 * 1024 * 1024, "2 MiB regions");
+    static_assert(LargeHeap::kMaxPages == 2 * CentralHeap::kMaxPages, "twice the pages per span");
+    static_assert(BigPageHeap::kRegionSizeBytes == CentralHeap::kRegionSizeBytes, "same region, bigger pages");
+
+    LargeHeap& large = LargeHeap::GetInstance();
+    BigPageHeap& big_page = BigPageHeap::GetInstance();
+    const size_t default_mapped = heap_.mapped_bytes();
+
+    // 默认配置放不下的 span 可以从 2 MiB Region 中整块取得
+    EXPECT_EQ(heap_.acquire_pages(LargeHeap::kMaxPages), nullptr);
+    PageGroup* whole = large.acquire_pages(LargeHeap::kMaxPages);
+    ASSERT_NE(whole, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(whole->start_address) % LargeHeap::kRegionSizeBytes, 0u);
+    static_cast<char*>(whole->start_address)[LargeHeap::kRegionSizeBytes - 1] = 1;
+
+    // 页按 16 KiB 切分：相邻的两次分配相距一个大页
+    PageGroup* p1 = big_page.acquire_pages(1);
+    PageGroup* p2 = big_page.acquire_pages(1);
+    ASSERT_NE(p1, nullptr);
+    ASSERT_NE(p2, nullptr);
+    const uintptr_t a1 = reinterpret_cast<uintptr_t>(p1->start_address);
+    const uintptr_t a2 = reinterpret_cast<uintptr_t>(p2->start_address);
+    EXPECT_EQ(std::max(a1, a2) - std::min(a1, a2), BigPageHeapConfig::kPageSize);
+
+    EXPECT_EQ(heap_.mapped_bytes(), default_mapped);
+    EXPECT_EQ(large.mapped_bytes(), LargeHeap::kRegionSizeBytes);
+    EXPECT_EQ(big_page.mapped_bytes(), BigPageHeap::kRegionSizeBytes);
+
+    large.release_pages(whole);
+    big_page.release_pages(p1);
+    big_page.release_pages(p2);
+    EXPECT_EQ(large.release_free_memory(), LargeHeap::kRegionSizeBytes);
+    EXPECT_EQ(large.mapped_bytes(), 0u);
+}
+
+
+// =====================================================================
+// 测试 7: 归还给操作系统的页只计一次，committed_bytes 随之下降
+// =====================================================================
+TEST_F(CentralHeapBlackBoxTest, PurgedPagesAreCountedOnce) {
+    PageGroup* a = heap_.acquire_pages(32);
+    ASSERT_NE(a, nullptr);
+    std::memset(a->start_address, 1, 32 * CentralHeap::kPageSize);
+    EXPECT_LE(heap_.committed_bytes(), heap_.mapped_bytes());
+
+    heap_.release_pages(a);
+    const size_t committed_before = heap_.committed_bytes();
+    const size_t released = heap_.release_free_memory();
+    EXPECT_EQ(committed_before - heap_.committed_bytes(), released);
+    EXPECT_EQ(heap_.release_free_memory(), 0u);
+
+    // 重新分发出去的页又算作占用
+    const size_t committed_purged = heap_.committed_bytes();
+    PageGroup* c = heap_.acquire_pages(32);
+    ASSERT_NE(c, nullptr);
+    EXPECT_GE(heap_.committed_bytes(), committed_purged + 31 * CentralHeap::kPageSize);
+
+    heap_.release_pages(c);
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+
+#include "gc_malloc/ConservativeCollector.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+#include "gc_malloc/TraceRecorder.hpp"
+
+namespace {
+
+// 测试里只以取反后的形式保存块地址，避免这些副本本身被当作指针
+uintptr_t hide(void* p) { return ~reinterpret_cast<uintptr_t>(p); }
+BlockHeader* header_of(uintptr_t hidden) {
+    return reinterpret_cast<BlockHeader*>(~hidden) - 1;
+}
+
+struct Node {
+    Node* next;
+    char payload[40];
+};
+
+// 通过 add_root 登记的根
+Node* g_root = nullptr;
+
+} // namespace
+
+class ConservativeCollectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        collector_.enable();
+        collector_.add_root(&g_root, sizeof(g_root));
+    }
+
+    void TearDown() override {
+        collector_.remove_root(&g_root);
+        g_root = nullptr;
+    }
+
+    ConservativeCollector& collector_ = ConservativeCollector::GetInstance();
+};
+
+// =====================================================================
+// 测试 1: 从根出发可达的链表被保留，其余块被释放
+// =====================================================================
+TEST_F(ConservativeCollectorTest, FreesUnreachableAndKeepsRootedChain) {
+    const int kChain = 16;
+    const int kGarbage = 64;
+    std::vector<uintptr_t> chain;
+    std::vector<uintptr_t> garbage;
+
+    // 在另一个线程中分配，线程退出后它的栈不再被扫描，
+    // 唯一指向链表的指针就是登记的根
+    std::thread([&] {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        Node* head = nullptr;
+        for (int i = 0; i < kChain; ++i) {
+            Node* n = static_cast<Node*>(th->allocate(sizeof(Node)));
+            n->next = head;
+            head = n;
+            chain.push_back(hide(n));
+        }
+        for (int i = 0; i < kGarbage; ++i) {
+            Node* n = static_cast<Node*>(th->allocate(sizeof(Node)));
+            n->next = nullptr;
+            garbage.push_back(hide(n));
+        }
+        g_root = head;
+    }).join();
+
+    // 保守扫描可能被其他测试留在栈上或寄存器中的旧字误判为引用，
+    // 因此不可达的块只要求大部分被释放；可达的块必须全部保留
+    auto count_freed = [](const std::vector<uintptr_t>& blocks) {
+        return static_cast<size_t>(std::count_if(blocks.begin(), blocks.end(), [](uintptr_t h) {
+            return header_of(h)->state == STATE_FREED;
+        }));
+    };
+
+    ConservativeCollector::Result result{};
+    ASSERT_TRUE(collector_.collect(&result));
+    EXPECT_GE(result.scanned_blocks, static_cast<size_t>(kChain + kGarbage));
+
+    for (uintptr_t h : chain) {
+        EXPECT_EQ(header_of(h)->state, STATE_IN_USE);
+    }
+    const size_t garbage_freed = count_freed(garbage);
+    EXPECT_GE(garbage_freed, static_cast<size_t>(kGarbage / 2));
+    EXPECT_GE(result.freed_blocks, garbage_freed);
+
+    // 注销根之后整条链表都不可达
+    g_root = nullptr;
+    ASSERT_TRUE(collector_.collect(&result));
+    const size_t chain_freed = count_freed(chain);
+    EXPECT_GE(chain_freed, static_cast<size_t>(kChain / 2));
+    EXPECT_GE(result.freed_blocks, chain_freed);
+}
+
+// =====================================================================
+// 测试 2: 只被另一个运行中线程的栈引用的块被保留
+// =====================================================================
+TEST_F(ConservativeCollectorTest, ScansStacksOfSuspendedThreads) {
+    std::atomic<int> phase{0};
+    uintptr_t held = 0;
+    uintptr_t dropped = 0;
+
+    std::thread worker([&] {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        Node* volatile local = static_cast<Node*>(th->allocate(sizeof(Node)));
+        held = hide(local);
+        dropped = hide(th->allocate(sizeof(Node)));
+        phase.store(1);
+        while (phase.load() != 2) {
+            std::this_thread::yield();
+        }
+        ThreadHeap::deallocate(local);
+    });
+
+    while (phase.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    ASSERT_TRUE(collector_.collect());
+    EXPECT_EQ(header_of(held)->state, STATE_IN_USE);
+    EXPECT_EQ(header_of(dropped)->state, STATE_FREED);
+
+    phase.store(2);
+    worker.join();
+}
+
+// =====================================================================
+// 测试 3: 开启 trace 时，被回收的块都留下释放记录
+// =====================================================================
+TEST_F(ConservativeCollectorTest, SweptBlocksAreTracedAsFrees) {
+    const std::string path = "/tmp/gc_malloc_collector_trace_" + std::to_string(getpid()) + ".bin";
+    TraceRecorder& recorder = TraceRecorder::GetInstance();
+    ASSERT_TRUE(recorder.start(path.c_str()));
+
+    std::vector<uintptr_t> garbage;
+    std::thread([&] {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        for (int i = 0; i < 32; ++i) {
+            garbage.push_back(hide(th->allocate(sizeof(Node))));
+        }
+    }).join();
+
+    ASSERT_TRUE(collector_.collect());
+    recorder.stop();
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(TraceRecorder::read_trace(path.c_str(), &records));
+    std::remove(path.c_str());
+
+    // 线程已经退出，被回收的块一直保持 STATE_FREED
+    size_t freed = 0;
+    for (uintptr_t h : garbage) {
+        if (header_of(h)->state != STATE_FREED) {
+            continue;
+        }
+        freed++;
+        const uintptr_t address = reinterpret_cast<uintptr_t>(header_of(h) + 1);
+        auto alloc = std::find_if(records.begin(), records.end(), [&](const TraceRecord& r) {
+            return r.op == TRACE_ALLOCATE && r.address == address;
+        });
+        auto free = std::find_if(records.begin(), records.end(), [&](const TraceRecord& r) {
+            return r.op == TRACE_FREE && r.address == address;
+        });
+        ASSERT_NE(alloc, records.end());
+        ASSERT_NE(free, records.end());
+        EXPECT_GE(free->timestamp_ns, alloc->timestamp_ns);
+    }
+    EXPECT_GE(freed, garbage.size() / 2);
+}
+
+// =====================================================================
+// 测试 4: 未启用时 collect 不做任何事
+// =====================================================================
+TEST(ConservativeCollectorDisabledTest, CollectRequiresEnable) {
+    ConservativeCollector& collector = ConservativeCollector::GetInstance();
+    if (collector.enabled()) {
+        GTEST_SKIP() << "collector already enabled by another test";
+    }
+    EXPECT_FALSE(collector.collect());
+}
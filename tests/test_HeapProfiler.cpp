@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cstdio>
+
+#include "gc_malloc/HeapProfiler.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+
+class HeapProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        th_ = ThreadHeap::GetInstance();
+        ASSERT_NE(th_, nullptr);
+    }
+
+    void TearDown() override {
+        profiler_.set_sample_period(0);
+    }
+
+    // 把 profile 写入临时文件后读回为字符串
+    std::string DumpProfile() {
+        FILE* tmp = std::tmpfile();
+        EXPECT_NE(tmp, nullptr);
+        profiler_.write_profile(tmp);
+        std::rewind(tmp);
+        std::string content;
+        char buf[4096];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), tmp)) > 0) {
+            content.append(buf, n);
+        }
+        std::fclose(tmp);
+        return content;
+    }
+
+    // 在采样关闭时分配，直到线程的倒计数重新读取采样间隔
+    void DrainRecheckInterval() {
+        for (size_t i = 0; i < HeapProfiler::kDisabledRecheckBytes / 4096 + 1; ++i) {
+            void* p = th_->allocate(4096);
+            ASSERT_NE(p, nullptr);
+            ThreadHeap::deallocate(p);
+        }
+        th_->garbage_collect();
+    }
+
+    ThreadHeap* th_;
+    HeapProfiler& profiler_ = HeapProfiler::GetInstance();
+};
+
+// =====================================================================
+// 测试 1: 采样关闭时不记录任何分配
+// =====================================================================
+TEST_F(HeapProfilerTest, NoSamplesWhenDisabled) {
+    profiler_.set_sample_period(0);
+    const size_t before = profiler_.live_sample_count();
+
+    std::vector<void*> pointers;
+    for (int i = 0; i < 100; ++i) {
+        pointers.push_back(th_->allocate(128));
+    }
+    EXPECT_EQ(profiler_.live_sample_count(), before);
+
+    for (void* p : pointers) {
+        ThreadHeap::deallocate(p);
+    }
+    th_->garbage_collect();
+}
+
+// =====================================================================
+// 测试 2: 采样开启后记录分配，GC 回收后移除
+// =====================================================================
+TEST_F(HeapProfilerTest, SamplesAreRecordedAndDroppedOnGC) {
+    // 采样间隔为 1 字节时，几乎每一次分配都会被采样
+    profiler_.set_sample_period(1);
+    DrainRecheckInterval();
+    const size_t before = profiler_.live_sample_count();
+
+    const int kCount = 50;
+    std::vector<void*> pointers;
+    for (int i = 0; i < kCount; ++i) {
+        void* p = th_->allocate(256);
+        ASSERT_NE(p, nullptr);
+        pointers.push_back(p);
+    }
+    EXPECT_EQ(profiler_.live_sample_count(), before + kCount);
+
+    for (void* p : pointers) {
+        ThreadHeap::deallocate(p);
+    }
+    th_->garbage_collect();
+    EXPECT_EQ(profiler_.live_sample_count(), before);
+}
+
+// =====================================================================
+// 测试 3: 输出符合 pprof 的 heap_v2 格式
+// =====================================================================
+TEST_F(HeapProfilerTest, ProfileHasPprofHeapFormat) {
+    profiler_.set_sample_period(1);
+    DrainRecheckInterval();
+
+    void* live = th_->allocate(1000);
+    ASSERT_NE(live, nullptr);
+
+    const std::string profile = DumpProfile();
+    EXPECT_EQ(profile.rfind("heap profile: ", 0), 0u);
+    EXPECT_NE(profile.find("@ heap_v2/1"), std::string::npos);
+    EXPECT_NE(profile.find("] @ 0x"), std::string::npos);
+    EXPECT_NE(profile.find("MAPPED_LIBRARIES:"), std::string::npos);
+
+    ThreadHeap::deallocate(live);
+    th_->garbage_collect();
+}
+
+// =====================================================================
+// 测试 4: 采样间隔服从给定均值
+// =====================================================================
+TEST_F(HeapProfilerTest, SampleDistanceFollowsPeriod) {
+    const size_t kPeriod = 512 * 1024;
+    profiler_.set_sample_period(kPeriod);
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    const int kRounds = 20000;
+    double sum = 0;
+    for (int i = 0; i < kRounds; ++i) {
+        sum += static_cast<double>(profiler_.next_sample_distance(&rng));
+    }
+    const double mean = sum / kRounds;
+    EXPECT_GT(mean, kPeriod * 0.9);
+    EXPECT_LT(mean, kPeriod * 1.1);
+
+    profiler_.set_sample_period(0);
+    EXPECT_EQ(profiler_.next_sample_distance(&rng), HeapProfiler::kDisabledRecheckBytes);
+}
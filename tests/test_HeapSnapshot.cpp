@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "gc_malloc/HeapSnapshot.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+
+static std::string read_file(const std::string& path) {
+    std::string content;
+    FILE* in = std::fopen(path.c_str(), "r");
+    if (in == nullptr) {
+        return content;
+    }
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), in)) > 0) {
+        content.append(buf, n);
+    }
+    std::fclose(in);
+    return content;
+}
+
+// =====================================================================
+// 测试 1: 快照中的空闲链表一致，类别利用率、大对象和占用图与分配相符
+// =====================================================================
+TEST(HeapSnapshotTest, CaptureReflectsLiveAllocations) {
+    ThreadHeap* heap = ThreadHeap::GetInstance();
+    const size_t kSmall = 64;
+    const size_t kLarge = 600 * 1024;
+    std::vector<void*> small;
+    for (int i = 0; i < 100; ++i) {
+        small.push_back(heap->allocate(kSmall));
+    }
+    void* large = heap->allocate(kLarge);
+    ASSERT_NE(large, nullptr);
+
+    HeapSnapshotData snapshot;
+    HeapSnapshot::capture(&snapshot);
+
+    EXPECT_EQ(snapshot.span_map.addr_list_spans, snapshot.span_map.size_list_spans);
+    EXPECT_FALSE(snapshot.span_map.regions.empty());
+    EXPECT_TRUE(std::is_sorted(snapshot.span_map.spans.begin(), snapshot.span_map.spans.end(),
+                               [](const CentralHeap::SpanInfo& a, const CentralHeap::SpanInfo& b) {
+                                   return a.start < b.start;
+                               }));
+
+    const size_t index = SizeClassInfo::map_size_to_index(kSmall + sizeof(BlockHeader));
+    const HeapSnapshotClass& c = snapshot.classes[index];
+    EXPECT_GE(c.in_use_blocks, 100u);
+    EXPECT_LE(c.in_use_blocks, c.total_blocks);
+    EXPECT_GE(snapshot.large_groups, 1u);
+    EXPECT_GE(snapshot.header_bytes, 101 * sizeof(BlockHeader));
+
+    // 当前线程的 ThreadHeap 出现在快照中，并持有大对象所在的 span
+    auto self = std::find_if(snapshot.threads.begin(), snapshot.threads.end(),
+                             [&](const HeapSnapshotThread& t) { return t.heap == heap; });
+    ASSERT_NE(self, snapshot.threads.end());
+    EXPECT_GE(self->in_use_bytes, kLarge + 100 * kSmall);
+
+    const std::vector<std::string> maps = HeapSnapshot::region_maps(snapshot);
+    ASSERT_EQ(maps.size(), snapshot.span_map.regions.size());
+    bool saw_large = false;
+    for (const std::string& map : maps) {
+        EXPECT_EQ(map.size(), CentralHeap::kPagesPerMmap);
+        saw_large |= map.find(HeapSnapshot::kMapLarge) != std::string::npos;
+    }
+    EXPECT_TRUE(saw_large);
+
+    char path[] = "/tmp/gc_malloc_snapshot_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    FILE* out = std::fopen(path, "w");
+    ASSERT_NE(out, nullptr);
+    HeapSnapshot::write(out, snapshot);
+    std::fclose(out);
+    const std::string report = read_file(path);
+    unlink(path);
+    EXPECT_NE(report.find("free span histogram"), std::string::npos);
+    EXPECT_NE(report.find("size class utilization"), std::string::npos);
+    EXPECT_NE(report.find("region map"), std::string::npos);
+    EXPECT_EQ(report.find("MISMATCH"), std::string::npos);
+
+    heap->deallocate(large);
+    for (void* p : small) {
+        heap->deallocate(p);
+    }
+}
+
+// =====================================================================
+// 测试 2: 收到信号后在后台线程中把报告写到文件
+// =====================================================================
+TEST(HeapSnapshotTest, SignalTriggersDump) {
+    const std::string path = "/tmp/gc_malloc_snapshot_signal_" + std::to_string(getpid());
+    unlink(path.c_str());
+    ASSERT_TRUE(HeapSnapshot::enable_signal_trigger(SIGUSR2, path.c_str()));
+    ASSERT_EQ(raise(SIGUSR2), 0);
+
+    // 报告写完时文件以区域图结尾，轮询等待后台线程
+    std::string report;
+    for (int i = 0; i < 200; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        report = read_file(path);
+        if (report.find("region map") != std::string::npos) {
+            break;
+        }
+    }
+    unlink(path.c_str());
+    EXPECT_NE(report.find("gc_malloc heap snapshot"), std::string::npos);
+    EXPECT_NE(report.find("region map"), std::string::npos);
+
+    signal(SIGUSR2, SIG_DFL);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <string>
+
+#include "gc_malloc/HeapStats.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/SizeClassInfo.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+
+class HeapStatsTest : public ::testing::Test {
+protected:
+    // 统计数据在整个进程内累计，测试只比较前后两次快照的差值
+    static HeapStatsSnapshot Snapshot() {
+        HeapStatsSnapshot s;
+        HeapStats::collect(&s);
+        return s;
+    }
+};
+
+// =====================================================================
+// 测试 1: 小对象的分配、回收与 refill 计数
+// =====================================================================
+TEST_F(HeapStatsTest, CountsSmallAllocationsAndFrees) {
+    const size_t alloc_size = 64;
+    const size_t index = SizeClassInfo::map_size_to_index(alloc_size + sizeof(BlockHeader));
+    const int kCount = 1000;
+
+    HeapStatsSnapshot before = Snapshot();
+
+    // 在新线程中运行，保证 refill 一定发生
+    std::thread worker([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        std::vector<void*> pointers;
+        for (int i = 0; i < kCount; ++i) {
+            void* p = th->allocate(alloc_size);
+            ASSERT_NE(p, nullptr);
+            pointers.push_back(p);
+        }
+        for (void* p : pointers) {
+            ThreadHeap::deallocate(p);
+        }
+        th->garbage_collect();
+    });
+    worker.join();
+
+    HeapStatsSnapshot after = Snapshot();
+
+    EXPECT_EQ(after.size_classes[index].alloc_count - before.size_classes[index].alloc_count, static_cast<uint64_t>(kCount));
+    EXPECT_EQ(after.size_classes[index].free_count - before.size_classes[index].free_count, static_cast<uint64_t>(kCount));
+    EXPECT_GT(after.size_classes[index].refill_count, before.size_classes[index].refill_count);
+    EXPECT_GE(after.gc_count - before.gc_count, 1u);
+    EXPECT_GE(after.gc_reclaimed_blocks - before.gc_reclaimed_blocks, static_cast<uint64_t>(kCount));
+    EXPECT_GT(after.thread_heap_count, before.thread_heap_count);
+}
+
+// =====================================================================
+// 测试 2: 大对象计数与 CentralHeap 映射统计
+// =====================================================================
+TEST_F(HeapStatsTest, CountsLargeObjectsAndMappedBytes) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+    const size_t large_size = 512 * 1024;
+
+    HeapStatsSnapshot before = Snapshot();
+
+    void* p = th->allocate(large_size);
+    ASSERT_NE(p, nullptr);
+
+    HeapStatsSnapshot during = Snapshot();
+    EXPECT_EQ(during.large_alloc_count - before.large_alloc_count, 1u);
+    EXPECT_GE(during.large_live_bytes, large_size);
+    EXPECT_GT(during.central.mapped_bytes, 0u);
+    EXPECT_LE(during.central.resident_bytes, during.central.mapped_bytes);
+    EXPECT_GT(during.metadata_objects, 0u);
+
+    ThreadHeap::deallocate(p);
+    th->garbage_collect();
+
+    HeapStatsSnapshot after = Snapshot();
+    EXPECT_EQ(after.large_free_count - before.large_free_count, 1u);
+    EXPECT_EQ(after.large_live_bytes, before.large_live_bytes);
+}
+
+// =====================================================================
+// 测试 3: 空闲 span 直方图与总量一致
+// =====================================================================
+TEST_F(HeapStatsTest, FreeSpanHistogramIsConsistent) {
+    HeapStatsSnapshot s = Snapshot();
+
+    size_t spans = 0;
+    size_t bytes = 0;
+    for (size_t pages = 0; pages <= CentralHeap::kMaxPages; ++pages) {
+        spans += s.central.free_spans_by_pages[pages];
+        bytes += s.central.free_spans_by_pages[pages] * pages * CentralHeap::kPageSize;
+    }
+    EXPECT_EQ(spans, s.central.free_span_count);
+    EXPECT_EQ(bytes, s.central.free_bytes);
+    EXPECT_LE(s.central.free_bytes, s.central.mapped_bytes);
+}
+
+// =====================================================================
+// 测试 4: JSON 输出包含各个分组
+// =====================================================================
+TEST_F(HeapStatsTest, JsonDumpContainsAllSections) {
+    HeapStatsSnapshot s = Snapshot();
+    const std::string json = HeapStats::to_json(s);
+
+    ASSERT_FALSE(json.empty());
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"size_classes\":["), std::string::npos);
+    EXPECT_NE(json.find("\"large\":{"), std::string::npos);
+    EXPECT_NE(json.find("\"gc\":{"), std::string::npos);
+    EXPECT_NE(json.find("\"central\":{"), std::string::npos);
+    EXPECT_NE(json.find("\"resident_bytes\""), std::string::npos);
+    EXPECT_NE(json.find("\"metadata\":{"), std::string::npos);
+}
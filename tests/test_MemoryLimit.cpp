@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "gc_malloc/MemoryLimit.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/PageGroup.hpp"
+
+class MemoryLimitTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        limit_.set_limits(0, 0);
+        limit_.set_hard_limit_callback(nullptr, nullptr);
+    }
+
+    MemoryLimit& limit_ = MemoryLimit::GetInstance();
+    CentralHeap& central_ = CentralHeap::GetInstance();
+};
+
+// =====================================================================
+// 测试 1: 越过软上限时回收缓存、通知其他线程并归还空闲内存
+// =====================================================================
+TEST_F(MemoryLimitTest, SoftLimitTriggersReclamation) {
+    MemoryLimit::Stats before;
+    limit_.collect_stats(&before);
+    const uint64_t generation_before = MemoryLimit::pressure_generation();
+
+    std::thread t([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        limit_.set_limits(central_.committed_bytes() + 2 * CentralHeap::kRegionSizeBytes, 0);
+
+        std::vector<void*> blocks;
+        for (int i = 0; i < 4096; ++i) {
+            blocks.push_back(th->allocate(1024));
+        }
+        for (void* p : blocks) {
+            ThreadHeap::deallocate(p);
+        }
+        th->trim();
+    });
+    t.join();
+
+    MemoryLimit::Stats after;
+    limit_.collect_stats(&after);
+    EXPECT_GT(after.soft_events, before.soft_events);
+    EXPECT_NE(MemoryLimit::pressure_generation(), generation_before);
+}
+
+// =====================================================================
+// 测试 2: 回收之后仍接近硬上限时调用回调
+// =====================================================================
+TEST_F(MemoryLimitTest, HardLimitInvokesCallback) {
+    struct CallbackState {
+        int calls = 0;
+        size_t hard_limit = 0;
+    } state;
+
+    limit_.set_hard_limit_callback([](size_t, size_t hard_limit, void* arg) {
+        CallbackState* s = static_cast<CallbackState*>(arg);
+        s->calls++;
+        s->hard_limit = hard_limit;
+    }, &state);
+
+    std::thread t([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const size_t base = central_.committed_bytes();
+        const size_t hard = base + 2 * CentralHeap::kRegionSizeBytes;
+        limit_.set_limits(base + CentralHeap::kRegionSizeBytes, hard);
+
+        // 存活数据超过硬上限，回收无法缓解
+        std::vector<void*> blocks;
+        for (int i = 0; i < 8192; ++i) {
+            blocks.push_back(th->allocate(1024));
+        }
+        EXPECT_GE(state.calls, 1);
+        EXPECT_EQ(state.hard_limit, hard);
+
+        for (void* p : blocks) {
+            ThreadHeap::deallocate(p);
+        }
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 3: 读取 cgroup memory.max 格式的文件
+// =====================================================================
+TEST_F(MemoryLimitTest, LoadsCgroupLimitFile) {
+    const std::string path = "/tmp/gc_malloc_memory_max_" + std::to_string(getpid());
+    auto write_file = [&](const char* content) {
+        FILE* f = std::fopen(path.c_str(), "w");
+        ASSERT_NE(f, nullptr);
+        std::fputs(content, f);
+        std::fclose(f);
+    };
+
+    write_file("104857600\n");
+    ASSERT_TRUE(limit_.load_cgroup_limit(path.c_str(), 0.75));
+    EXPECT_EQ(limit_.hard_limit(), 104857600u);
+    EXPECT_EQ(limit_.soft_limit(), 78643200u);
+
+    write_file("max\n");
+    ASSERT_TRUE(limit_.load_cgroup_limit(path.c_str()));
+    EXPECT_EQ(limit_.hard_limit(), 0u);
+    EXPECT_EQ(limit_.soft_limit(), 0u);
+
+    std::remove(path.c_str());
+    EXPECT_FALSE(limit_.load_cgroup_limit(path.c_str()));
+}
+
+// =====================================================================
+// 测试 4: 回收按未归还的字节衡量，能把占用降到软上限以下，且不重复计数
+// =====================================================================
+TEST_F(MemoryLimitTest, ReliefLowersCommittedBytesBelowSoftLimit) {
+    // 每个 Region 留下最后一页不释放，其余页写过之后还给 CentralHeap，
+    // 这样空闲 span 不会因为整个 Region 空闲而被直接 munmap
+    const size_t kBigPages = CentralHeap::kMaxPages - 1;
+    std::vector<PageGroup*> pins;
+    std::vector<PageGroup*> bigs;
+    while (bigs.size() < 6) {
+        PageGroup* big = central_.acquire_pages(kBigPages);
+        PageGroup* pin = central_.acquire_pages(1);
+        ASSERT_NE(big, nullptr);
+        ASSERT_NE(pin, nullptr);
+        pins.push_back(pin);
+        std::memset(big->start_address, 1, kBigPages * CentralHeap::kPageSize);
+        if (pin->start_address == static_cast<char*>(big->start_address) + kBigPages * CentralHeap::kPageSize) {
+            bigs.push_back(big);
+        } else {
+            central_.release_pages(big);
+        }
+    }
+    for (PageGroup* big : bigs) {
+        central_.release_pages(big);
+    }
+
+    // 空闲页仍然占用物理内存，此时越过软上限
+    const size_t committed = central_.committed_bytes();
+    ASSERT_GT(committed, 4 * CentralHeap::kRegionSizeBytes);
+    limit_.set_limits(committed - CentralHeap::kRegionSizeBytes, 0);
+    ASSERT_TRUE(MemoryLimit::over_threshold());
+
+    MemoryLimit::Stats before;
+    limit_.collect_stats(&before);
+    limit_.relieve_pressure();
+    MemoryLimit::Stats after;
+    limit_.collect_stats(&after);
+
+    EXPECT_LT(central_.committed_bytes(), limit_.soft_limit());
+    EXPECT_FALSE(MemoryLimit::over_threshold());
+    EXPECT_EQ(after.released_bytes - before.released_bytes, committed - central_.committed_bytes());
+
+    // 已经归还的页不会在下一次回收中重复计数
+    EXPECT_EQ(central_.release_free_memory(), 0u);
+
+    for (PageGroup* pin : pins) {
+        central_.release_pages(pin);
+    }
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gc_malloc/MemoryResource.hpp"
+#include "gc_malloc/Allocator.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+
+// =====================================================================
+// 测试 1: Allocator<T> 可用于标准容器，内存来自 ThreadHeap
+// =====================================================================
+TEST(MemoryResourceTest, AllocatorBacksStandardContainers) {
+    std::vector<int, Allocator<int>> v;
+    for (int i = 0; i < 10000; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_EQ(v[9999], 9999);
+    EXPECT_EQ((reinterpret_cast<BlockHeader*>(v.data()) - 1)->state, STATE_IN_USE);
+
+    std::list<std::string, Allocator<std::string>> l;
+    l.push_back("gc_malloc");
+    l.push_back("list");
+    EXPECT_EQ(l.front(), "gc_malloc");
+
+    EXPECT_TRUE(Allocator<int>() == Allocator<double>());
+    ThreadHeap::GetInstance()->garbage_collect();
+}
+
+// =====================================================================
+// 测试 2: pmr 容器与超过自然对齐的请求
+// =====================================================================
+TEST(MemoryResourceTest, PmrResourceHonoursAlignment) {
+    std::pmr::memory_resource* resource = ThreadHeapResource::GetInstance();
+    EXPECT_TRUE(resource->is_equal(*ThreadHeapResource::GetInstance()));
+    EXPECT_FALSE(resource->is_equal(*std::pmr::new_delete_resource()));
+
+    {
+        std::pmr::unordered_map<int, std::pmr::string> map(resource);
+        for (int i = 0; i < 1000; ++i) {
+            map.emplace(i, std::to_string(i) + " some text long enough to allocate");
+        }
+        EXPECT_EQ(map.at(123).substr(0, 3), "123");
+    }
+
+    for (size_t alignment : {16, 64, 256, 4096}) {
+        void* p = resource->allocate(100, alignment);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0u);
+        std::memset(p, 0xAB, 100);
+        resource->deallocate(p, 100, alignment);
+    }
+    ThreadHeap::GetInstance()->garbage_collect();
+}
+
+// =====================================================================
+// 测试 3: 加上对齐余量后会回绕的请求失败，而不是返回过小的块
+// =====================================================================
+TEST(MemoryResourceTest, HugeAlignedRequestsFail) {
+    struct alignas(64) AlignedTo64 {
+        char bytes[64];
+    };
+
+    for (size_t alignment : {16, 64, 4096}) {
+        EXPECT_EQ(ThreadHeapResource::allocate_bytes(SIZE_MAX - alignment + 1, alignment), nullptr);
+        EXPECT_EQ(ThreadHeapResource::allocate_bytes(SIZE_MAX, alignment), nullptr);
+    }
+
+    // 大小在运行时读出，否则 GCC 会对常量参数报 -Walloc-size-larger-than
+    volatile size_t huge_size = SIZE_MAX - 63;
+    std::pmr::memory_resource* resource = ThreadHeapResource::GetInstance();
+    EXPECT_THROW((void)resource->allocate(huge_size, 64), std::bad_alloc);
+
+    std::pmr::polymorphic_allocator<AlignedTo64> alloc(resource);
+    EXPECT_THROW((void)alloc.allocate(huge_size / sizeof(AlignedTo64)), std::bad_alloc);
+}
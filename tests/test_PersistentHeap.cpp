@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "gc_malloc/PersistentHeap.hpp"
+
+class PersistentHeapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/gc_malloc_persistent_XXXXXX";
+        const int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        path_ = path;
+    }
+
+    void TearDown() override {
+        unlink(path_.c_str());
+    }
+
+    std::string path_;
+};
+
+struct PersistentNode {
+    PersistentNode* next;
+    int value;
+    char payload[100];
+};
+
+// =====================================================================
+// 测试 1: 重新打开后通过根指针找回数据，指针无需任何转换
+// =====================================================================
+TEST_F(PersistentHeapTest, DataSurvivesReopen) {
+    const size_t kSize = 4 * 1024 * 1024;
+    void* base = nullptr;
+    {
+        PersistentHeap heap;
+        ASSERT_TRUE(heap.open(path_.c_str(), kSize));
+        EXPECT_TRUE(heap.was_created());
+        base = heap.base();
+
+        PersistentNode* head = nullptr;
+        for (int i = 0; i < 1000; ++i) {
+            PersistentNode* node = heap.create<PersistentNode>();
+            ASSERT_NE(node, nullptr);
+            node->value = i;
+            node->next = head;
+            head = node;
+        }
+        // 大对象走整页分配
+        char* big = static_cast<char*>(heap.allocate(600 * 1024));
+        ASSERT_NE(big, nullptr);
+        std::memset(big, 0x7E, 600 * 1024);
+
+        heap.set_root(0, head);
+        heap.set_root(1, big);
+        heap.close();
+        EXPECT_FALSE(heap.is_open());
+    }
+
+    PersistentHeap heap;
+    // 已有文件沿用其中记录的大小
+    ASSERT_TRUE(heap.open(path_.c_str(), 0));
+    EXPECT_FALSE(heap.was_created());
+    EXPECT_TRUE(heap.was_clean());
+    EXPECT_EQ(heap.base(), base);
+    EXPECT_EQ(heap.size(), kSize);
+
+    int expected = 999;
+    for (auto* node = static_cast<PersistentNode*>(heap.root(0)); node != nullptr; node = node->next) {
+        EXPECT_EQ(node->value, expected--);
+    }
+    EXPECT_EQ(expected, -1);
+    const char* big = static_cast<const char*>(heap.root(1));
+    EXPECT_EQ(big[0], 0x7E);
+    EXPECT_EQ(big[600 * 1024 - 1], 0x7E);
+
+    // 恢复后的空闲链表仍然可用
+    PersistentNode* node = heap.create<PersistentNode>();
+    ASSERT_NE(node, nullptr);
+    heap.deallocate(node);
+}
+
+// =====================================================================
+// 测试 2: 未正常关闭、基址冲突与格式不符
+// =====================================================================
+TEST_F(PersistentHeapTest, RejectsConflictsAndReportsUncleanShutdown) {
+    PersistentHeap heap;
+    ASSERT_TRUE(heap.open(path_.c_str(), 1024 * 1024));
+    heap.set_root(3, heap.allocate(64));
+    ASSERT_TRUE(heap.sync());
+
+    // 同一文件再次打开需要同一基址，不能覆盖已有映射
+    PersistentHeap second;
+    EXPECT_FALSE(second.open(path_.c_str(), 0));
+    EXPECT_FALSE(heap.open(path_.c_str(), 0));
+
+    // 模拟崩溃：不经过 close 就把文件复制一份再打开
+    const std::string copy = path_ + ".copy";
+    {
+        FILE* out = std::fopen(copy.c_str(), "wb");
+        ASSERT_NE(out, nullptr);
+        std::fwrite(heap.base(), 1, heap.size(), out);
+        std::fclose(out);
+    }
+    heap.close();
+
+    ASSERT_TRUE(second.open(copy.c_str(), 0));
+    EXPECT_FALSE(second.was_clean());
+    EXPECT_NE(second.root(3), nullptr);
+    second.close();
+
+    // 不是持久化堆的文件
+    {
+        FILE* out = std::fopen(copy.c_str(), "wb");
+        ASSERT_NE(out, nullptr);
+        std::fputs("not a heap", out);
+        std::fclose(out);
+    }
+    EXPECT_FALSE(second.open(copy.c_str(), 0));
+    unlink(copy.c_str());
+}
+
+// =====================================================================
+// 测试 3: 空间用尽后返回 nullptr，释放的页可以重新分配给任意大小
+// =====================================================================
+TEST_F(PersistentHeapTest, ReusesFreedPagesAfterExhaustion) {
+    PersistentHeap heap;
+    ASSERT_TRUE(heap.open(path_.c_str(), 8 * 1024 * 1024));
+
+    const size_t kLarge = 300 * 1024;
+    std::vector<void*> blocks;
+    for (;;) {
+        void* p = heap.allocate(kLarge);
+        if (p == nullptr) {
+            break;
+        }
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0u);
+        blocks.push_back(p);
+    }
+    ASSERT_GT(blocks.size(), 10u);
+    EXPECT_EQ(heap.allocate(kLarge), nullptr);
+
+    // 相邻页段合并后足以容纳更大的请求
+    for (void* p : blocks) {
+        heap.deallocate(p);
+    }
+    void* huge = heap.allocate(4 * 1024 * 1024);
+    ASSERT_NE(huge, nullptr);
+    std::memset(huge, 0, 4 * 1024 * 1024);
+    heap.deallocate(huge);
+
+    for (int i = 0; i < 10000; ++i) {
+        void* p = heap.allocate(48);
+        ASSERT_NE(p, nullptr);
+        blocks[i % blocks.size()] = p;
+    }
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+
+#include "gc_malloc/SegmentHeap.hpp"
+
+// 在一块普通内存上建立段：第一页放 State，其余页交给 SegmentHeap
+class SegmentHeapTest : public ::testing::Test {
+protected:
+    static constexpr size_t kSegmentBytes = 256 * SegmentHeap::kPageSize;
+
+    void SetUp() override {
+        base_ = static_cast<char*>(std::aligned_alloc(SegmentHeap::kPageSize, kSegmentBytes));
+        ASSERT_NE(base_, nullptr);
+        std::memset(base_, 0, kSegmentBytes);
+        state_ = reinterpret_cast<SegmentHeap::State*>(base_);
+        SegmentHeap::initialize(state_, kSegmentBytes, SegmentHeap::kPageSize);
+        heap_ = SegmentHeap(base_, state_);
+    }
+
+    void TearDown() override {
+        std::free(base_);
+    }
+
+    // 占用 num_pages 整页的请求，块头占 16 字节
+    static size_t page_request(size_t num_pages) {
+        return num_pages * SegmentHeap::kPageSize - 16;
+    }
+
+    char* base_ = nullptr;
+    SegmentHeap::State* state_ = nullptr;
+    SegmentHeap heap_;
+};
+
+// =====================================================================
+// 测试 1: 释放的页段与两侧相邻的页段合并成一个
+// =====================================================================
+TEST_F(SegmentHeapTest, ReleasedRunsMergeWithBothNeighbours) {
+    const size_t pages = kSizeClassBlockSizes[kNumSizeClasses - 1] / SegmentHeap::kPageSize + 1;
+    ASSERT_GE(SizeClassInfo::map_size_to_index(page_request(pages) + 16), kNumSizeClasses);
+
+    size_t offsets[4];
+    for (size_t& offset : offsets) {
+        offset = heap_.allocate(page_request(pages));
+        ASSERT_NE(offset, 0u);
+        EXPECT_EQ(offset % 16, 0u);
+    }
+    heap_.deallocate(offsets[0]);
+    heap_.deallocate(offsets[2]);
+    heap_.deallocate(offsets[1]);
+
+    // 三段合并后只剩一个页段，恰好容纳三倍大小的请求，并从它的起点开始
+    const size_t merged = heap_.allocate(page_request(3 * pages));
+    EXPECT_EQ(merged, offsets[0]);
+    EXPECT_EQ(state_->free_runs, 0u);
+
+    heap_.deallocate(merged);
+    heap_.deallocate(offsets[3]);
+}
+
+// =====================================================================
+// 测试 2: 紧邻 top 的页段退回到 top，全部释放后段恢复初始状态
+// =====================================================================
+TEST_F(SegmentHeapTest, TrailingRunsReturnToTop) {
+    const size_t pages = kSizeClassBlockSizes[kNumSizeClasses - 1] / SegmentHeap::kPageSize + 1;
+    const size_t first = heap_.allocate(page_request(pages));
+    const size_t second = heap_.allocate(page_request(pages));
+    ASSERT_NE(first, 0u);
+    ASSERT_NE(second, 0u);
+
+    heap_.deallocate(first);
+    EXPECT_NE(state_->free_runs, 0u);
+
+    // second 退回 top 时先与前面的页段合并，整体退回
+    heap_.deallocate(second);
+    EXPECT_EQ(state_->free_runs, 0u);
+    EXPECT_EQ(state_->top, SegmentHeap::kPageSize);
+
+    // 空间不足时返回 0，不改变状态
+    EXPECT_EQ(heap_.allocate(kSegmentBytes), 0u);
+    EXPECT_EQ(state_->top, SegmentHeap::kPageSize);
+}
+
+// =====================================================================
+// 测试 3: 布局指纹随段头大小变化
+// =====================================================================
+TEST(SegmentHeapLayoutTest, FingerprintCoversHeaderSize) {
+    EXPECT_EQ(SegmentHeap::layout_fingerprint(128), SegmentHeap::layout_fingerprint(128));
+    EXPECT_NE(SegmentHeap::layout_fingerprint(128), SegmentHeap::layout_fingerprint(136));
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gc_malloc/SharedHeap.hpp"
+
+// 在子进程中运行 fn，返回它的退出码；子进程不使用 gtest 断言
+template <typename Fn>
+static int run_in_child(Fn&& fn) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+        _exit(fn());
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+struct SharedMessage {
+    size_t payload_offset;      // 段内引用必须保存偏移
+    size_t length;
+};
+
+// =====================================================================
+// 测试 1: 子进程分配并写入的消息，父进程在不同的映射地址上读取并释放
+// =====================================================================
+TEST(SharedHeapTest, ObjectsCrossProcessesWithoutCopies) {
+    SharedHeap heap;
+    ASSERT_TRUE(heap.create(8 * 1024 * 1024));
+
+    const size_t kLength = 512 * 1024;
+    const int rc = run_in_child([&]() {
+        // 不复用继承下来的映射，重新 attach 得到另一个地址
+        SharedHeap child;
+        if (!child.attach(heap.fd()) || child.base() == heap.base()) {
+            return 1;
+        }
+        SharedMessage* msg = child.create_object<SharedMessage>();
+        char* payload = static_cast<char*>(child.allocate(kLength));
+        if (msg == nullptr || payload == nullptr) {
+            return 2;
+        }
+        for (size_t i = 0; i < kLength; ++i) {
+            payload[i] = static_cast<char>(i * 7);
+        }
+        msg->payload_offset = child.to_offset(payload);
+        msg->length = kLength;
+        child.set_root(0, msg);
+        return 0;
+    });
+    ASSERT_EQ(rc, 0);
+
+    auto* msg = static_cast<SharedMessage*>(heap.root(0));
+    ASSERT_NE(msg, nullptr);
+    ASSERT_EQ(msg->length, kLength);
+    const char* payload = static_cast<const char*>(heap.from_offset(msg->payload_offset));
+    for (size_t i = 0; i < kLength; i += 4093) {
+        ASSERT_EQ(payload[i], static_cast<char>(i * 7));
+    }
+
+    // 在父进程中释放子进程分配的对象，页可以重新分配
+    heap.deallocate(const_cast<char*>(payload));
+    heap.deallocate(msg);
+    heap.set_root(0, nullptr);
+    void* again = heap.allocate(kLength);
+    EXPECT_EQ(again, payload);
+    heap.deallocate(again);
+}
+
+// =====================================================================
+// 测试 2: 两个进程并发分配释放，共享锁保证元数据一致
+// =====================================================================
+TEST(SharedHeapTest, ConcurrentProcessesShareOneLock) {
+    SharedHeap heap;
+    ASSERT_TRUE(heap.create(16 * 1024 * 1024));
+
+    auto churn = [](SharedHeap& h, unsigned char tag) {
+        void* live[64] = {};
+        for (int i = 0; i < 20000; ++i) {
+            const int slot = i % 64;
+            if (live[slot] != nullptr) {
+                if (*static_cast<unsigned char*>(live[slot]) != tag) {
+                    return 1;
+                }
+                h.deallocate(live[slot]);
+            }
+            const size_t size = (i % 7 == 0) ? 300 * 1024 : 16 + (i * 37) % 2000;
+            live[slot] = h.allocate(size);
+            if (live[slot] == nullptr) {
+                return 2;
+            }
+            std::memset(live[slot], tag, size);
+        }
+        for (void* p : live) {
+            h.deallocate(p);
+        }
+        return 0;
+    };
+
+    const pid_t pid = fork();
+    if (pid == 0) {
+        SharedHeap child;
+        _exit(child.attach(heap.fd()) ? churn(child, 0xC1) : 3);
+    }
+    ASSERT_GT(pid, 0);
+    const int parent_rc = churn(heap, 0xA5);
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_EQ(parent_rc, 0);
+
+    // 两个进程释放的大对象页段合并后可以容纳更大的请求
+    EXPECT_NE(heap.allocate(8 * 1024 * 1024), nullptr);
+}
+
+// =====================================================================
+// 测试 3: 偏移转换与非法段
+// =====================================================================
+TEST(SharedHeapTest, OffsetsAndInvalidSegments) {
+    SharedHeap heap;
+    EXPECT_FALSE(heap.create(SharedHeap::kPageSize));
+    ASSERT_TRUE(heap.create(1024 * 1024));
+    EXPECT_FALSE(heap.create(1024 * 1024));
+
+    EXPECT_EQ(heap.to_offset(nullptr), 0u);
+    EXPECT_EQ(heap.from_offset(0), nullptr);
+    void* p = heap.allocate(100);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0u);
+    EXPECT_EQ(heap.from_offset(heap.to_offset(p)), p);
+
+    // 同一进程内再次 attach 得到另一份映射，看到相同的数据
+    SharedHeap view;
+    ASSERT_TRUE(view.attach(heap.fd()));
+    std::strcpy(static_cast<char*>(p), "hello");
+    EXPECT_STREQ(static_cast<char*>(view.from_offset(heap.to_offset(p))), "hello");
+    view.deallocate(view.from_offset(heap.to_offset(p)));
+    view.detach();
+    EXPECT_FALSE(view.is_open());
+
+    // 不是 SharedHeap 的 fd
+    int pipe_fds[2];
+    ASSERT_EQ(pipe(pipe_fds), 0);
+    EXPECT_FALSE(view.attach(pipe_fds[0]));
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
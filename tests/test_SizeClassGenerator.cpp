@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "gc_malloc/SizeClassGenerator.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+
+class SizeClassGeneratorTest : public ::testing::Test {
+protected:
+    static bool has_block_size(const std::vector<GeneratedSizeClass>& classes, size_t block_size) {
+        for (const GeneratedSizeClass& c : classes) {
+            if (c.block_size == block_size) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// =====================================================================
+// 测试 1: 生成的表满足格式约束，并始终覆盖最大块大小
+// =====================================================================
+TEST_F(SizeClassGeneratorTest, GeneratedTableIsWellFormed) {
+    std::vector<SizeHistogramEntry> histogram;
+    for (size_t size = 8; size <= 8192; size *= 2) {
+        histogram.push_back({size, 1000});
+        histogram.push_back({size + size / 2, 500});
+    }
+
+    SizeClassGeneratorOptions options;
+    std::vector<GeneratedSizeClass> classes;
+    ASSERT_TRUE(SizeClassGenerator::generate(histogram, options, &classes));
+
+    ASSERT_FALSE(classes.empty());
+    EXPECT_LE(classes.size(), options.num_classes);
+    EXPECT_EQ(classes.back().block_size, options.max_block_size);
+    for (size_t i = 0; i < classes.size(); ++i) {
+        EXPECT_EQ(classes[i].block_size % options.alignment, 0u);
+        EXPECT_GE(classes[i].pages_to_acquire, 1u);
+        EXPECT_LE(classes[i].pages_to_acquire, options.max_pages);
+        EXPECT_GE(classes[i].pages_to_acquire * CentralHeap::kPageSize / classes[i].block_size,
+                  options.min_blocks_per_group);
+        if (i > 0) {
+            EXPECT_GT(classes[i].block_size, classes[i - 1].block_size);
+        }
+    }
+}
+
+// =====================================================================
+// 测试 2: 集中在某个大小的负载会得到贴合的类别，浪费低于默认表
+// =====================================================================
+TEST_F(SizeClassGeneratorTest, FitsClusteredWorkloadBetterThanDefault) {
+    // 200 字节请求加 24 字节头部恰好是 224
+    std::vector<SizeHistogramEntry> histogram = {
+        {24, 100}, {200, 100000}, {1000, 50}, {6000, 10},
+    };
+
+    std::vector<GeneratedSizeClass> classes;
+    ASSERT_TRUE(SizeClassGenerator::generate(histogram, SizeClassGeneratorOptions(), &classes));
+    EXPECT_TRUE(has_block_size(classes, 224));
+
+    std::vector<GeneratedSizeClass> current;
+    SizeClassGenerator::current_classes(&current);
+    EXPECT_LT(SizeClassGenerator::expected_waste(histogram, classes),
+              SizeClassGenerator::expected_waste(histogram, current));
+}
+
+// =====================================================================
+// 测试 3: 页数选择与非法参数
+// =====================================================================
+TEST_F(SizeClassGeneratorTest, PageChoiceAndInvalidOptions) {
+    SizeClassGeneratorOptions options;
+    // 192 字节在 3 页时恰好切分，没有尾部浪费
+    EXPECT_EQ(SizeClassGenerator::choose_pages(192, options), 3u);
+    EXPECT_EQ(SizeClassGenerator::choose_pages(16384, options), 32u);
+
+    std::vector<GeneratedSizeClass> classes;
+    options.max_block_size = 1000;
+    EXPECT_FALSE(SizeClassGenerator::generate({{100, 1}}, options, &classes));
+    options.max_block_size = 16384;
+    options.num_classes = 0;
+    EXPECT_FALSE(SizeClassGenerator::generate({{100, 1}}, options, &classes));
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdio>
+
+#include "gc_malloc/SizeHistogram.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+
+class SizeHistogramTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SizeHistogram::reset();
+    }
+
+    void TearDown() override {
+        SizeHistogram::disable();
+        SizeHistogram::reset();
+    }
+
+    static uint64_t count_for(const std::vector<SizeHistogramEntry>& entries, size_t size) {
+        for (const SizeHistogramEntry& e : entries) {
+            if (e.size == size) {
+                return e.count;
+            }
+        }
+        return 0;
+    }
+};
+
+// =====================================================================
+// 测试 1: 分桶边界，桶上界包含落入该桶的所有大小
+// =====================================================================
+TEST_F(SizeHistogramTest, BucketBoundaries) {
+    EXPECT_EQ(SizeHistogram::bucket_index(1), 0u);
+    EXPECT_EQ(SizeHistogram::bucket_index(8), 0u);
+    EXPECT_EQ(SizeHistogram::bucket_index(9), 1u);
+    EXPECT_EQ(SizeHistogram::bucket_upper_bound(SizeHistogram::bucket_index(1024)), 1024u);
+    EXPECT_EQ(SizeHistogram::bucket_upper_bound(SizeHistogram::bucket_index(1025)), 1088u);
+    EXPECT_EQ(SizeHistogram::bucket_upper_bound(SizeHistogram::bucket_index(2048)), 2048u);
+    EXPECT_EQ(SizeHistogram::bucket_index(SizeHistogram::kMaxTrackedSize + 1), SizeHistogram::kNumBuckets - 1);
+
+    for (size_t size = 1; size <= SizeHistogram::kMaxTrackedSize; size += 7) {
+        const size_t index = SizeHistogram::bucket_index(size);
+        ASSERT_LT(index, SizeHistogram::kNumBuckets - 1);
+        EXPECT_GE(SizeHistogram::bucket_upper_bound(index), size);
+        if (index > 0) {
+            EXPECT_LT(SizeHistogram::bucket_upper_bound(index - 1), size);
+        }
+    }
+}
+
+// =====================================================================
+// 测试 2: 开启后记录分配大小，关闭后不再记录；导出后可以读回
+// =====================================================================
+TEST_F(SizeHistogramTest, RecordsAllocationsAndRoundTrips) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+
+    SizeHistogram::enable();
+    std::vector<void*> pointers;
+    for (int i = 0; i < 10; ++i) {
+        pointers.push_back(th->allocate(200));
+    }
+    pointers.push_back(th->allocate(3000));
+    SizeHistogram::disable();
+    pointers.push_back(th->allocate(200));
+
+    for (void* p : pointers) {
+        ThreadHeap::deallocate(p);
+    }
+    th->garbage_collect();
+
+    std::vector<SizeHistogramEntry> entries;
+    SizeHistogram::collect(&entries);
+    EXPECT_EQ(count_for(entries, 200), 10u);
+    EXPECT_EQ(count_for(entries, SizeHistogram::bucket_upper_bound(SizeHistogram::bucket_index(3000))), 1u);
+
+    FILE* f = std::tmpfile();
+    ASSERT_NE(f, nullptr);
+    SizeHistogram::dump(f);
+    std::rewind(f);
+    std::vector<SizeHistogramEntry> read_back;
+    ASSERT_TRUE(SizeHistogram::read(f, &read_back));
+    std::fclose(f);
+
+    ASSERT_EQ(read_back.size(), entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        EXPECT_EQ(read_back[i].size, entries[i].size);
+        EXPECT_EQ(read_back[i].count, entries[i].count);
+    }
+}
@@ -1,14 +1,19 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <thread>
+#include <atomic>
 #include <unordered_set>
 #include <chrono>
 #include <random>
+#include <cstring>
+#include <algorithm>
 
 #include "gc_malloc/ThreadHeap.hpp"
 #include "gc_malloc/BlockHeader.hpp"
 #include "gc_malloc/CentralHeap.hpp"
 #include "gc_malloc/SizeClassInfo.hpp"
+#include "gc_malloc/PageGroup.hpp"
+#include "gc_malloc/MemoryLimit.hpp"
 
 class ThreadHeapTest : public ::testing::Test {
 protected:
@@ -47,7 +52,7 @@ TEST_F(ThreadHeapTest, SmallObjectAllocationAndGC) {
 // 测试 2: 大对象分配与回收
 // =====================================================================
 TEST_F(ThreadHeapTest, LargeObjectAllocationAndGC) {
-    const size_t large_alloc_size = 32 * 1024; // 32KB
+    const size_t large_alloc_size = 512 * 1024; // 512KB，超过最大的中等类别
 
     void* p1 = th_->allocate(large_alloc_size);
     ASSERT_NE(p1, nullptr);
@@ -348,4 +353,793 @@ TEST_F(ThreadHeapTest, HighFrequencyRefillAndGC) {
         t.join();
     }
     SUCCEED();
-}
\ No newline at end of file
+}
+
+// =====================================================================
+// 测试 10: 请求大小恰好等于 块大小-头部 时，写满用户空间不会破坏相邻块
+// =====================================================================
+TEST_F(ThreadHeapTest, FullPayloadDoesNotOverlapNeighbour) {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        const size_t payload = SizeClassInfo::get_block_size_for_index(i) - sizeof(BlockHeader);
+        void* a = th_->allocate(payload);
+        void* b = th_->allocate(payload);
+        ASSERT_NE(a, nullptr);
+        ASSERT_NE(b, nullptr);
+
+        memset(a, 0xAB, payload);
+        memset(b, 0xCD, payload);
+
+        // 两个块的头部都必须保持完整
+        EXPECT_EQ((static_cast<BlockHeader*>(a) - 1)->state, STATE_IN_USE);
+        EXPECT_EQ((static_cast<BlockHeader*>(b) - 1)->state, STATE_IN_USE);
+        EXPECT_EQ(static_cast<unsigned char*>(a)[payload - 1], 0xAB);
+
+        ThreadHeap::deallocate(a);
+        ThreadHeap::deallocate(b);
+    }
+    th_->garbage_collect();
+}
+
+
+// =====================================================================
+// 测试 11: 突发分配释放后，单个类别的缓存不超过上限
+// =====================================================================
+TEST_F(ThreadHeapTest, BurstCacheIsBoundedAfterGC) {
+    const size_t alloc_size = 1000;
+    const size_t kCount = 4096; // 约 4 MiB，远超单个类别的缓存上限
+
+    th_->garbage_collect();
+    const size_t cached_before = th_->cached_bytes();
+
+    std::vector<void*> pointers;
+    for (size_t i = 0; i < kCount; ++i) {
+        void* p = th_->allocate(alloc_size);
+        ASSERT_NE(p, nullptr);
+        pointers.push_back(p);
+    }
+    for (void* p : pointers) {
+        ThreadHeap::deallocate(p);
+    }
+    th_->garbage_collect();
+
+    EXPECT_LE(th_->cached_bytes(), cached_before + ThreadHeap::kMaxClassCacheBytes);
+    EXPECT_LE(th_->cached_bytes(), std::max(ThreadHeap::thread_cache_budget(), cached_before));
+}
+
+// =====================================================================
+// 测试 12: 线程退出时未回收的块被清理，空闲 PageGroup 全部归还
+// =====================================================================
+TEST_F(ThreadHeapTest, ThreadExitReturnsCachedPages) {
+    CentralHeap::Stats before;
+    CentralHeap::GetInstance().collect_stats(&before);
+
+    size_t cached_after_trim = 1;
+    std::thread t([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        std::vector<void*> pointers;
+        for (int i = 0; i < 2000; ++i) {
+            pointers.push_back(th->allocate(i % 2 == 0 ? 64 : 3000));
+        }
+        for (void* p : pointers) {
+            ThreadHeap::deallocate(p);
+        }
+        th->trim();
+        cached_after_trim = th->cached_bytes();
+
+        // 退出前不调用 garbage_collect，由线程退出时的清理负责
+        for (int i = 0; i < 2000; ++i) {
+            ThreadHeap::deallocate(th->allocate(200));
+        }
+    });
+    t.join();
+
+    EXPECT_EQ(cached_after_trim, 0u);
+
+    CentralHeap::Stats after;
+    CentralHeap::GetInstance().collect_stats(&after);
+    EXPECT_EQ(after.pages_in_use, before.pages_in_use);
+}
+
+// =====================================================================
+// 测试 13: 仍有存活块的 PageGroup 不会被归还，存活块释放后整组归还
+// =====================================================================
+TEST_F(ThreadHeapTest, PartialGroupsAreKeptUntilEmpty) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const size_t alloc_size = 4000;
+        const size_t index = SizeClassInfo::map_size_to_index(alloc_size + sizeof(BlockHeader));
+        const size_t group_bytes = SizeClassInfo::get_pages_to_acquire_for_index(index) * CentralHeap::kPageSize;
+        const size_t blocks_per_group = group_bytes / SizeClassInfo::get_block_size_for_index(index);
+        const size_t kGroups = 16;
+
+        CentralHeap::Stats before;
+        CentralHeap::GetInstance().collect_stats(&before);
+
+        std::vector<void*> pointers;
+        for (size_t i = 0; i < kGroups * blocks_per_group; ++i) {
+            pointers.push_back(th->allocate(alloc_size));
+        }
+
+        // 每组保留一个块，其余全部释放
+        std::vector<void*> survivors;
+        for (size_t i = 0; i < pointers.size(); ++i) {
+            if (i % blocks_per_group == 0) {
+                survivors.push_back(pointers[i]);
+            } else {
+                ThreadHeap::deallocate(pointers[i]);
+            }
+        }
+        th->trim();
+
+        CentralHeap::Stats partial;
+        CentralHeap::GetInstance().collect_stats(&partial);
+        EXPECT_EQ(partial.pages_in_use - before.pages_in_use, kGroups * group_bytes / CentralHeap::kPageSize);
+
+        for (void* p : survivors) {
+            ThreadHeap::deallocate(p);
+        }
+        th->trim();
+
+        CentralHeap::Stats after;
+        CentralHeap::GetInstance().collect_stats(&after);
+        EXPECT_EQ(after.pages_in_use, before.pages_in_use);
+        EXPECT_EQ(th->cached_bytes(), 0u);
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 14: 分配优先使用占用率最高的 PageGroup
+// =====================================================================
+TEST_F(ThreadHeapTest, AllocatesFromFullestGroupFirst) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const size_t alloc_size = 4000;
+        const size_t index = SizeClassInfo::map_size_to_index(alloc_size + sizeof(BlockHeader));
+        const size_t blocks_per_group = SizeClassInfo::get_pages_to_acquire_for_index(index) *
+                                        CentralHeap::kPageSize / SizeClassInfo::get_block_size_for_index(index);
+        ASSERT_GE(blocks_per_group, 8u);
+
+        // 三个组依次保留 少量 / 大部分 / 一半 的块
+        const size_t keep[3] = {1, blocks_per_group - 2, blocks_per_group / 2};
+        std::vector<void*> groups[3];
+        for (auto& g : groups) {
+            for (size_t i = 0; i < blocks_per_group; ++i) {
+                g.push_back(th->allocate(alloc_size));
+            }
+        }
+        auto owner = [](void* p) { return (static_cast<BlockHeader*>(p) - 1)->owner_group; };
+        for (int g = 0; g < 3; ++g) {
+            for (size_t i = keep[g]; i < blocks_per_group; ++i) {
+                ThreadHeap::deallocate(groups[g][i]);
+            }
+        }
+        th->garbage_collect();
+
+        // 先填满保留最多的组，再轮到保留一半的组
+        for (size_t i = 0; i < blocks_per_group - keep[1]; ++i) {
+            void* p = th->allocate(alloc_size);
+            EXPECT_EQ(owner(p), owner(groups[1][0]));
+        }
+        void* p = th->allocate(alloc_size);
+        EXPECT_EQ(owner(p), owner(groups[2][0]));
+
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 15: 新组按需从组首依次切分，refill 时不访问块内存
+// =====================================================================
+TEST_F(ThreadHeapTest, RefillCarvesBlocksLazily) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const size_t alloc_size = 2000;
+        const size_t index = SizeClassInfo::map_size_to_index(alloc_size + sizeof(BlockHeader));
+        const size_t block_size = SizeClassInfo::get_block_size_for_index(index);
+
+        BlockHeader* first = static_cast<BlockHeader*>(th->allocate(alloc_size)) - 1;
+        PageGroup* group = first->owner_group;
+        EXPECT_EQ(reinterpret_cast<char*>(first), static_cast<char*>(group->start_address) + group->color_offset);
+        EXPECT_EQ(group->carved_block_count, 1);
+
+        for (int i = 1; i < 4; ++i) {
+            BlockHeader* h = static_cast<BlockHeader*>(th->allocate(alloc_size)) - 1;
+            EXPECT_EQ(reinterpret_cast<char*>(h), reinterpret_cast<char*>(first) + i * block_size);
+            EXPECT_EQ(h->owner_group, group);
+        }
+        EXPECT_EQ(group->carved_block_count, 4);
+        EXPECT_LT(group->carved_block_count, group->total_block_count);
+
+        // 回收后的块优先于尚未切分的部分被复用
+        void* reused = first + 1;
+        ThreadHeap::deallocate(reused);
+        th->garbage_collect();
+        EXPECT_EQ(th->allocate(alloc_size), reused);
+        EXPECT_EQ(group->carved_block_count, 4);
+
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 16: 存活的块晋升到老年代，常规扫描只访问年轻代
+// =====================================================================
+TEST_F(ThreadHeapTest, GenerationalSweepSkipsOldBlocks) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const ThreadHeapCounters& c = th->counters();
+        const size_t kLongLived = 256;
+        const size_t kShortLived = 32;
+
+        std::vector<void*> long_lived;
+        for (size_t i = 0; i < kLongLived; ++i) {
+            long_lived.push_back(th->allocate(48));
+        }
+        for (size_t i = 0; i < ThreadHeap::kPromotionAge; ++i) {
+            th->garbage_collect();
+        }
+        EXPECT_EQ(c.gc_promoted_blocks.load(), kLongLived);
+        for (void* p : long_lived) {
+            EXPECT_EQ((static_cast<BlockHeader*>(p) - 1)->state, STATE_IN_USE_OLD);
+        }
+
+        // 只有新分配的块会被访问
+        for (size_t i = 0; i < kShortLived; ++i) {
+            ThreadHeap::deallocate(th->allocate(48));
+        }
+        const uint64_t swept_before = c.gc_swept_blocks.load();
+        th->garbage_collect();
+        EXPECT_EQ(c.gc_swept_blocks.load() - swept_before, kShortLived);
+        EXPECT_EQ(c.gc_old_sweeps.load(), 0u);
+
+        // 老年代中的垃圾达到阈值后，下一次扫描会访问老年代
+        const size_t kDead = kLongLived / ThreadHeap::kOldGarbageRatio;
+        for (size_t i = 0; i < kDead; ++i) {
+            ThreadHeap::deallocate(long_lived[i]);
+        }
+        const uint64_t reclaimed_before = c.gc_reclaimed_blocks.load();
+        th->garbage_collect();
+        EXPECT_EQ(c.gc_old_sweeps.load(), 1u);
+        EXPECT_EQ(c.gc_reclaimed_blocks.load() - reclaimed_before, kDead);
+
+        for (size_t i = kDead; i < kLongLived; ++i) {
+            ThreadHeap::deallocate(long_lived[i]);
+        }
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 17: retire 的块要等到之前进入临界区的线程都退出后才会被回收
+// =====================================================================
+TEST_F(ThreadHeapTest, RetiredBlockWaitsForReaders) {
+    std::atomic<int> phase{0};
+
+    std::thread reader([&]() {
+        EpochGuard guard;
+        {
+            EpochGuard nested;      // 嵌套进入不会改变已公布的 epoch
+        }
+        phase.store(1);
+        while (phase.load() != 2) {
+            std::this_thread::yield();
+        }
+    });
+    while (phase.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    std::thread owner([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const ThreadHeapCounters& c = th->counters();
+        void* p = th->allocate(64);
+        const uint64_t reclaimed_before = c.gc_reclaimed_blocks.load();
+
+        ThreadHeap::retire(p);
+        EXPECT_TRUE(state_is_retired((static_cast<BlockHeader*>(p) - 1)->state));
+        for (int i = 0; i < 4; ++i) {
+            th->garbage_collect();
+        }
+        EXPECT_EQ(c.gc_reclaimed_blocks.load(), reclaimed_before);
+
+        // 读者退出后，全局 epoch 推进两次即可回收
+        phase.store(2);
+        reader.join();
+        for (int i = 0; i < 3; ++i) {
+            th->garbage_collect();
+        }
+        EXPECT_EQ(c.gc_reclaimed_blocks.load() - reclaimed_before, 1u);
+        th->trim();
+    });
+    owner.join();
+}
+
+// =====================================================================
+// 测试 18: 缓存行对齐模式下每个块都从 64 字节边界开始
+// =====================================================================
+TEST_F(ThreadHeapTest, BlocksStartOnCacheLinesInAlignedMode) {
+#ifndef GC_MALLOC_CACHE_ALIGNED_BLOCKS
+    GTEST_SKIP() << "built without GC_MALLOC_CACHE_ALIGNED";
+#else
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        const size_t payload = SizeClassInfo::get_block_size_for_index(i) - sizeof(BlockHeader);
+        for (int j = 0; j < 4; ++j) {
+            BlockHeader* header = static_cast<BlockHeader*>(th_->allocate(payload)) - 1;
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(header) % kCacheLineSize, 0u);
+            ThreadHeap::deallocate(header + 1);
+        }
+    }
+    th_->garbage_collect();
+#endif
+}
+
+// =====================================================================
+// 测试 19: 新组的第一个块依次错开一条缓存行
+// =====================================================================
+TEST_F(ThreadHeapTest, NewGroupsAreColoured) {
+    // 尺寸类别表可以在编译时替换，从表中挑第一个切分后尾部至少留下一条缓存行的类别
+    size_t index = 0;
+    while (index < kNumSizeClasses &&
+           SizeClassInfo::get_pages_to_acquire_for_index(index) * CentralHeap::kPageSize %
+                   SizeClassInfo::get_block_size_for_index(index) < kCacheLineSize) {
+        index++;
+    }
+    if (index == kNumSizeClasses) {
+        GTEST_SKIP() << "no size class leaves a cache line of tail space";
+    }
+
+    std::thread t([index]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const size_t block_size = SizeClassInfo::get_block_size_for_index(index);
+        const size_t alloc_size = block_size - sizeof(BlockHeader);
+        const size_t group_bytes = SizeClassInfo::get_pages_to_acquire_for_index(index) * CentralHeap::kPageSize;
+        const size_t blocks = group_bytes / block_size;
+        const size_t num_colors = (group_bytes - blocks * block_size) / kCacheLineSize + 1;
+        ASSERT_GT(num_colors, 1u);
+
+        std::vector<void*> held;
+        PageGroup* last = nullptr;
+        size_t groups = 0;
+        for (size_t i = 0; i < (num_colors + 1) * blocks; ++i) {
+            void* p = th->allocate(alloc_size);
+            held.push_back(p);
+            PageGroup* group = (static_cast<BlockHeader*>(p) - 1)->owner_group;
+            if (group != last) {
+                EXPECT_EQ(group->color_offset, (groups % num_colors) * kCacheLineSize);
+                EXPECT_EQ(static_cast<char*>(p) - sizeof(BlockHeader),
+                          static_cast<char*>(group->start_address) + group->color_offset);
+                last = group;
+                groups++;
+            }
+            // 着色之后最后一个块仍在组内
+            EXPECT_LE(static_cast<char*>(p) + block_size - sizeof(BlockHeader),
+                      static_cast<char*>(group->start_address) + group_bytes);
+        }
+        EXPECT_EQ(groups, num_colors + 1);
+
+        for (void* p : held) {
+            ThreadHeap::deallocate(p);
+        }
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 20: 中等对象走尺寸类别，释放后在线程内复用，不再每次向 CentralHeap 申请
+// =====================================================================
+TEST_F(ThreadHeapTest, MediumObjectsAreCachedPerThread) {
+    // 尺寸类别表可以在编译时替换。从表中挑最大的中等类别，要求刚好超出前一个
+    // 类别的请求落到它上面时内部碎片也不超过 20%，请求取这个最坏情况
+    size_t medium_index = kNumSizeClasses;
+    size_t medium_size = 0;
+    for (size_t i = kNumSizeClasses; i-- > 1;) {
+        const size_t block_size = kSizeClassBlockSizes[i];
+        const size_t size = kSizeClassBlockSizes[i - 1] - sizeof(BlockHeader) + 1;
+        if (block_size > 16384 && block_size - size <= block_size / 5) {
+            medium_index = i;
+            medium_size = size;
+            break;
+        }
+    }
+    if (medium_index == kNumSizeClasses) {
+        GTEST_SKIP() << "no medium size class within 20% internal fragmentation";
+    }
+
+    std::thread t([medium_index, medium_size]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const size_t index = SizeClassInfo::map_size_to_index(medium_size + sizeof(BlockHeader));
+        ASSERT_EQ(index, medium_index);
+        const size_t block_size = SizeClassInfo::get_block_size_for_index(index);
+        // 内部碎片有界
+        EXPECT_LE(block_size - medium_size, block_size / 5);
+
+        const ThreadHeapCounters& c = th->counters();
+        const uint64_t large_before = c.large_alloc_count.load();
+
+        void* p1 = th->allocate(medium_size);
+        ASSERT_NE(p1, nullptr);
+        std::memset(p1, 0x5A, medium_size);
+        const uint64_t refills = c.refill_count[index].load();
+        ThreadHeap::deallocate(p1);
+        th->garbage_collect();
+
+        for (int i = 0; i < 100; ++i) {
+            void* p = th->allocate(medium_size);
+            ASSERT_NE(p, nullptr);
+            ThreadHeap::deallocate(p);
+            th->garbage_collect();
+        }
+        EXPECT_EQ(c.refill_count[index].load(), refills);
+        EXPECT_EQ(c.large_alloc_count.load(), large_before);
+
+        // 超过最大类别的请求仍然走大对象路径
+        void* big = th->allocate(kSizeClassBlockSizes[kNumSizeClasses - 1]);
+        ASSERT_NE(big, nullptr);
+        EXPECT_EQ(c.large_alloc_count.load(), large_before + 1);
+        ThreadHeap::deallocate(big);
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 21: 回收的大对象 span 在线程内复用，trim 时归还
+// =====================================================================
+TEST_F(ThreadHeapTest, LargeSpansAreReusedFromThreadCache) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const ThreadHeapCounters& c = th->counters();
+        const size_t large_size = 400 * 1024;
+
+        void* p1 = th->allocate(large_size);
+        ASSERT_NE(p1, nullptr);
+        ThreadHeap::deallocate(p1);
+        th->garbage_collect();
+        EXPECT_GE(th->large_cached_bytes(), large_size);
+
+        // 稍小一点的请求也可以复用同一个 span
+        const uint64_t hits = c.large_cache_hits.load();
+        void* p2 = th->allocate(large_size - 8 * 1024);
+        EXPECT_EQ(p2, p1);
+        EXPECT_EQ(c.large_cache_hits.load(), hits + 1);
+        EXPECT_EQ(th->large_cached_bytes(), 0u);
+        std::memset(p2, 0x11, large_size - 8 * 1024);
+
+        // 远小于缓存 span 的请求不复用它
+        void* small_large = th->allocate(300 * 1024);
+        ThreadHeap::deallocate(p2);
+        th->garbage_collect();
+        void* p3 = th->allocate(large_size / 2);
+        EXPECT_NE(p3, p2);
+        EXPECT_EQ(c.large_cache_hits.load(), hits + 1);
+
+        // 缓存总量受预算限制
+        std::vector<void*> spans;
+        for (int i = 0; i < 8; ++i) {
+            spans.push_back(th->allocate(large_size));
+        }
+        for (void* p : spans) {
+            ThreadHeap::deallocate(p);
+        }
+        th->garbage_collect();
+        EXPECT_LE(th->large_cached_bytes(), ThreadHeap::kLargeCacheBytes);
+
+        ThreadHeap::deallocate(small_large);
+        ThreadHeap::deallocate(p3);
+        th->trim();
+        EXPECT_EQ(th->large_cached_bytes(), 0u);
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 22: 查表映射与逐个比较块大小的结果一致，中等类别的组不超过线程预算下限
+// =====================================================================
+TEST_F(ThreadHeapTest, SizeClassMappingMatchesTable) {
+    const size_t max_block = kSizeClassBlockSizes[kNumSizeClasses - 1];
+    for (size_t size = 0; size <= max_block + 64; ++size) {
+        size_t expected = 0;
+        while (expected < kNumSizeClasses && kSizeClassBlockSizes[expected] < size) {
+            expected++;
+        }
+        ASSERT_EQ(SizeClassInfo::map_size_to_index(size), expected) << "size " << size;
+    }
+    EXPECT_EQ(SizeClassInfo::map_size_to_index(SIZE_MAX), kNumSizeClasses);
+    static_assert(SizeClassInfo::constexpr_index_for(1) == 0, "");
+
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        const size_t block_size = SizeClassInfo::get_block_size_for_index(i);
+        const size_t group_bytes = SizeClassInfo::get_pages_to_acquire_for_index(i) * CentralHeap::kPageSize;
+        EXPECT_GE(group_bytes, block_size);
+        EXPECT_LE(group_bytes, std::max(ThreadHeap::kMinThreadCacheBytes, block_size)) << "class " << i;
+    }
+}
+
+// =====================================================================
+// 测试 23: 尺寸映射计入 BlockHeader，写满用户空间不会越过块的末尾，接近 SIZE_MAX 的请求失败
+// =====================================================================
+TEST_F(ThreadHeapTest, PayloadDoesNotOverrunNextBlock) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        for (size_t i = 0; i < kNumSizeClasses && kSizeClassBlockSizes[i] <= 16384; ++i) {
+            // 恰好填满本类别的请求，以及只比它多几个字节、曾经被映射到本类别的请求
+            const size_t exact = kSizeClassBlockSizes[i] - sizeof(BlockHeader);
+            for (size_t size : {exact, exact + 1, exact + sizeof(BlockHeader)}) {
+                void* a = th->allocate(size);
+                void* b = th->allocate(size);
+                ASSERT_NE(a, nullptr);
+                ASSERT_NE(b, nullptr);
+                BlockHeader* ha = static_cast<BlockHeader*>(a) - 1;
+                BlockHeader* hb = static_cast<BlockHeader*>(b) - 1;
+                EXPECT_GE(ha->owner_group->block_size, size + sizeof(BlockHeader)) << "size " << size;
+                if (size == exact) {
+                    EXPECT_EQ(ha->owner_group->block_size, kSizeClassBlockSizes[i]);
+                } else {
+                    EXPECT_GT(ha->owner_group->block_size, kSizeClassBlockSizes[i]);
+                }
+
+                const PageGroup* group_b = hb->owner_group;
+                std::memset(a, 0xA5, size);
+                std::memset(b, 0x5A, size);
+                // 相邻块的头部保持完整
+                ASSERT_EQ(ha->state, STATE_IN_USE);
+                ASSERT_EQ(hb->state, STATE_IN_USE);
+                ASSERT_EQ(hb->owner_group, group_b);
+
+                ThreadHeap::deallocate(a);
+                ThreadHeap::deallocate(b);
+            }
+        }
+
+        // 加上头部后会回绕的请求直接失败，不能落到小类别或页数为 0 的大对象上
+        for (size_t size : {SIZE_MAX, SIZE_MAX - 10, SIZE_MAX - sizeof(BlockHeader),
+                            SIZE_MAX - sizeof(BlockHeader) - 1, SIZE_MAX - CentralHeap::kPageSize}) {
+            EXPECT_EQ(th->allocate(size), nullptr) << "size " << size;
+        }
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 24: garbage_collect 按大对象回收超出所有尺寸类别的块，不碰小对象的缓存
+// =====================================================================
+TEST_F(ThreadHeapTest, GarbageCollectReclaimsLargeObjectsAsLarge) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const ThreadHeapCounters& c = th->counters();
+        const size_t max_block = kSizeClassBlockSizes[kNumSizeClasses - 1];
+        // 刚好超出最大类别的请求，以及跨越多页、超过单个 Region 一半的请求
+        const size_t sizes[] = {max_block - sizeof(BlockHeader) + 1, max_block, 600 * 1024};
+
+        uint64_t small_frees_before = 0;
+        for (size_t i = 0; i < kNumSizeClasses; ++i) {
+            small_frees_before += c.free_count[i].load();
+        }
+        const uint64_t large_frees_before = c.large_free_count.load();
+        const size_t cached_before = th->cached_bytes() - th->large_cached_bytes();
+
+        for (size_t size : sizes) {
+            void* p = th->allocate(size);
+            ASSERT_NE(p, nullptr);
+            EXPECT_GE((static_cast<BlockHeader*>(p) - 1)->owner_group->block_size, size + sizeof(BlockHeader));
+            std::memset(p, 0x3C, size);
+            ThreadHeap::deallocate(p);
+        }
+        th->garbage_collect();
+
+        uint64_t small_frees_after = 0;
+        for (size_t i = 0; i < kNumSizeClasses; ++i) {
+            small_frees_after += c.free_count[i].load();
+        }
+        EXPECT_EQ(c.large_free_count.load(), large_frees_before + 3);
+        EXPECT_EQ(small_frees_after, small_frees_before);
+        EXPECT_EQ(th->cached_bytes() - th->large_cached_bytes(), cached_before);
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 25: 大对象 span 缓存计入线程预算，线程很多时随预算收缩
+// =====================================================================
+TEST_F(ThreadHeapTest, LargeSpanCacheCountsAgainstBudget) {
+    const size_t large_size = 200 * 1024;
+
+    std::thread few([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        ThreadHeap::deallocate(th->allocate(large_size));
+        th->garbage_collect();
+        EXPECT_GT(th->large_cached_bytes(), large_size);
+        EXPECT_GE(th->cached_bytes(), th->large_cached_bytes());
+        th->trim();
+    });
+    few.join();
+
+    // 让足够多的线程持有 ThreadHeap，预算降到下限
+    const size_t kParked = ThreadHeap::kOverallCacheBytes / ThreadHeap::kMinThreadCacheBytes + 8;
+    std::atomic<bool> release{false};
+    std::atomic<size_t> started{0};
+    std::vector<std::thread> parked;
+    for (size_t i = 0; i < kParked; ++i) {
+        parked.emplace_back([&]() {
+            ThreadHeap::GetInstance();
+            started.fetch_add(1);
+            while (!release.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    while (started.load() < kParked) {
+        std::this_thread::yield();
+    }
+
+    std::thread many([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        EXPECT_EQ(ThreadHeap::thread_cache_budget(), ThreadHeap::kMinThreadCacheBytes);
+        for (int i = 0; i < 4; ++i) {
+            ThreadHeap::deallocate(th->allocate(large_size));
+            th->garbage_collect();
+            EXPECT_LE(th->large_cached_bytes(), ThreadHeap::thread_cache_budget());
+        }
+        EXPECT_LE(th->cached_bytes(), ThreadHeap::thread_cache_budget());
+        th->trim();
+    });
+    many.join();
+
+    release.store(true);
+    for (auto& t : parked) {
+        t.join();
+    }
+}
+
+// =====================================================================
+// 测试 26: 其他线程请求的 trim 在下一次进入分配慢路径时生效
+// =====================================================================
+TEST_F(ThreadHeapTest, TrimRequestIsHonouredOnSlowPath) {
+    std::atomic<int> phase{0};
+    size_t before = 0;
+    size_t after = 1;
+    std::thread t([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        std::vector<void*> pointers;
+        for (int i = 0; i < 512; ++i) {
+            pointers.push_back(th->allocate(1000));
+        }
+        for (void* p : pointers) {
+            ThreadHeap::deallocate(p);
+        }
+        th->garbage_collect();
+        before = th->cached_bytes();
+        phase.store(1);
+        while (phase.load() != 2) {
+            std::this_thread::yield();
+        }
+
+        // 大对象分配总是经过慢路径，不调用 garbage_collect
+        void* large = th->allocate(300 * 1024);
+        after = th->cached_bytes();
+        ThreadHeap::deallocate(large);
+        th->trim();
+    });
+    while (phase.load() != 1) {
+        std::this_thread::yield();
+    }
+    MemoryLimit::request_trim();
+    phase.store(2);
+    t.join();
+
+    EXPECT_GT(before, 0u);
+    EXPECT_EQ(after, 0u);
+}
+
+// =====================================================================
+// 测试 27: 只分配、不调用 garbage_collect 的线程缓存也会按周期衰减
+// =====================================================================
+TEST_F(ThreadHeapTest, IdleCacheDecaysFromAllocationPath) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        std::vector<void*> pointers;
+        for (int i = 0; i < 512; ++i) {
+            pointers.push_back(th->allocate(1000));
+        }
+        for (void* p : pointers) {
+            ThreadHeap::deallocate(p);
+        }
+        th->garbage_collect();
+        const size_t before = th->cached_bytes();
+        ASSERT_GT(before, 0u);
+
+        // 第一个周期从突发结束时开始统计 low_water，第二个周期才归还整段未用到的块
+        std::vector<void*> large;
+        for (int tick = 0; tick < 2; ++tick) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(ThreadHeap::kDecayIntervalNs) +
+                                        std::chrono::milliseconds(50));
+            large.push_back(th->allocate(300 * 1024));
+        }
+        EXPECT_LT(th->cached_bytes(), before);
+        for (void* p : large) {
+            ThreadHeap::deallocate(p);
+        }
+        th->trim();
+    });
+    t.join();
+}
+
+// =====================================================================
+// 测试 28: 线程缓存总量超过总预算时请求所有线程 trim，线程退出后总量回落
+// =====================================================================
+TEST_F(ThreadHeapTest, OverallCacheOverflowRequestsTrim) {
+    const size_t kThreads = ThreadHeap::kOverallCacheBytes / ThreadHeap::kMinThreadCacheBytes + 64;
+    const uint64_t generation_before = MemoryLimit::pressure_generation();
+    std::atomic<bool> release{false};
+    std::atomic<size_t> ready{0};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&]() {
+            ThreadHeap* th = ThreadHeap::GetInstance();
+            std::vector<void*> pointers;
+            for (int j = 0; j < 192; ++j) {
+                pointers.push_back(th->allocate(1000));
+            }
+            for (void* p : pointers) {
+                ThreadHeap::deallocate(p);
+            }
+            th->garbage_collect();
+            ready.fetch_add(1);
+            while (!release.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    while (ready.load() < kThreads) {
+        std::this_thread::yield();
+    }
+
+    EXPECT_GT(ThreadHeap::total_cached_bytes(), ThreadHeap::kOverallCacheBytes);
+    EXPECT_NE(MemoryLimit::pressure_generation(), generation_before);
+
+    release.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_LT(ThreadHeap::total_cached_bytes(), ThreadHeap::kOverallCacheBytes);
+}
+
+// =====================================================================
+// 测试 29: trim 把 CentralHeap 中零散的空闲页还给操作系统
+// =====================================================================
+TEST_F(ThreadHeapTest, TrimReleasesScatteredFreePages) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        CentralHeap& central = CentralHeap::GetInstance();
+        const size_t large_size = 200 * 1024;
+        std::vector<void*> large;
+        for (int i = 0; i < 100; ++i) {
+            void* p = th->allocate(large_size);
+            ASSERT_NE(p, nullptr);
+            std::memset(p, 0x5A, large_size);
+            large.push_back(p);
+        }
+        // 每 4 个保留一个，幸存者让各个 Region 都无法整体 munmap
+        for (size_t i = 0; i < large.size(); ++i) {
+            if (i % 4 != 0) {
+                ThreadHeap::deallocate(large[i]);
+            }
+        }
+        // 释放的 span 在 trim 的扫描中回到 CentralHeap，约 15 MiB 零散的空闲页
+        th->trim();
+        EXPECT_LE(central.unreleased_free_bytes(), ThreadHeap::kFreePagesReleaseBytes);
+
+        for (size_t i = 0; i < large.size(); i += 4) {
+            ThreadHeap::deallocate(large[i]);
+        }
+        th->trim();
+    });
+    t.join();
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <string>
+#include <cstdio>
+#include <algorithm>
+#include <unistd.h>
+
+#include "gc_malloc/TraceRecorder.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/BlockHeader.hpp"
+#include "gc_malloc/SizeClassInfo.hpp"
+
+class TraceRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = "/tmp/gc_malloc_trace_test_" + std::to_string(getpid()) + ".bin";
+    }
+
+    void TearDown() override {
+        recorder_.stop();
+        std::remove(path_.c_str());
+    }
+
+    std::string path_;
+    TraceRecorder& recorder_ = TraceRecorder::GetInstance();
+};
+
+// =====================================================================
+// 测试 1: 单线程事件按顺序完整记录
+// =====================================================================
+TEST_F(TraceRecorderTest, RecordsAllocateFreeAndCollect) {
+    ThreadHeap* th = ThreadHeap::GetInstance();
+
+    ASSERT_TRUE(recorder_.start(path_.c_str()));
+    EXPECT_TRUE(TraceRecorder::enabled());
+
+    void* p1 = th->allocate(100);
+    void* p2 = th->allocate(5000);
+    ThreadHeap::deallocate(p1);
+    ThreadHeap::deallocate(p2);
+    th->garbage_collect();
+
+    recorder_.stop();
+    EXPECT_FALSE(TraceRecorder::enabled());
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(TraceRecorder::read_trace(path_.c_str(), &records));
+    ASSERT_EQ(records.size(), 5u);
+
+    EXPECT_EQ(records[0].op, TRACE_ALLOCATE);
+    EXPECT_EQ(records[0].size, 100u);
+    EXPECT_EQ(records[0].address, reinterpret_cast<uintptr_t>(p1));
+    EXPECT_EQ(records[1].op, TRACE_ALLOCATE);
+    EXPECT_EQ(records[1].size, 5000u);
+    EXPECT_EQ(records[2].op, TRACE_FREE);
+    EXPECT_EQ(records[2].address, reinterpret_cast<uintptr_t>(p1));
+    EXPECT_EQ(records[3].op, TRACE_FREE);
+    EXPECT_EQ(records[4].op, TRACE_COLLECT);
+
+    for (size_t i = 1; i < records.size(); ++i) {
+        EXPECT_GE(records[i].timestamp_ns, records[i - 1].timestamp_ns);
+        EXPECT_EQ(records[i].thread_id, records[0].thread_id);
+    }
+}
+
+// =====================================================================
+// 测试 2: 多线程下每个线程的记录都能落盘，且线程编号不同
+// =====================================================================
+TEST_F(TraceRecorderTest, MultiThreadedBuffersAreFlushed) {
+    const int kNumThreads = 4;
+    // 超过单个缓冲区容量，强制中途刷新
+    const int kAllocsPerThread = static_cast<int>(TraceRecorder::kBufferRecords) * 2;
+
+    ASSERT_TRUE(recorder_.start(path_.c_str()));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&]() {
+            ThreadHeap* th = ThreadHeap::GetInstance();
+            for (int i = 0; i < kAllocsPerThread; ++i) {
+                ThreadHeap::deallocate(th->allocate(64));
+            }
+            th->garbage_collect();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    recorder_.stop();
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(TraceRecorder::read_trace(path_.c_str(), &records));
+    EXPECT_EQ(records.size(), static_cast<size_t>(kNumThreads * (kAllocsPerThread * 2 + 1)));
+
+    std::vector<uint32_t> ids;
+    for (const TraceRecord& r : records) {
+        if (r.op == TRACE_COLLECT) {
+            ids.push_back(r.thread_id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(std::unique(ids.begin(), ids.end()) - ids.begin(), kNumThreads);
+}
+
+// =====================================================================
+// 测试 3: 关闭时不产生记录，非法文件被拒绝
+// =====================================================================
+TEST_F(TraceRecorderTest, DisabledRecorderAndInvalidFile) {
+    EXPECT_FALSE(TraceRecorder::enabled());
+
+    FILE* f = std::fopen(path_.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fputs("not a trace", f);
+    std::fclose(f);
+
+    std::vector<TraceRecord> records;
+    EXPECT_FALSE(TraceRecorder::read_trace(path_.c_str(), &records));
+    EXPECT_FALSE(TraceRecorder::read_trace("/nonexistent/dir/trace.bin", &records));
+}
+
+// =====================================================================
+// 测试 4: 超过 4 GiB 的大小按原值记录，不被截断
+// =====================================================================
+TEST_F(TraceRecorderTest, LargeSizesAreNotClamped) {
+    const uint64_t kHugeSize = (uint64_t(1) << 33) + 123;
+    int dummy = 0;
+
+    ASSERT_TRUE(recorder_.start(path_.c_str()));
+    recorder_.record(TRACE_ALLOCATE, &dummy, kHugeSize);
+    recorder_.stop();
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(TraceRecorder::read_trace(path_.c_str(), &records));
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].size, kHugeSize);
+    EXPECT_EQ(records[0].address, reinterpret_cast<uintptr_t>(&dummy));
+}
+
+// =====================================================================
+// 测试 5: allocate_batch 取出的块也记录分配，之后的释放都能配对
+// =====================================================================
+TEST_F(TraceRecorderTest, BatchAllocationsAreRecorded) {
+    std::thread t([&]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const size_t index = SizeClassInfo::map_size_to_index(48 + sizeof(BlockHeader));
+        const size_t usable = SizeClassInfo::get_block_size_for_index(index) - sizeof(BlockHeader);
+        void* blocks[16];
+
+        ASSERT_TRUE(recorder_.start(path_.c_str()));
+        const size_t n = th->allocate_batch(index, blocks, 16);
+        ASSERT_EQ(n, 16u);
+        for (size_t i = 0; i < n; ++i) {
+            ThreadHeap::deallocate(blocks[i]);
+        }
+        recorder_.stop();
+        th->garbage_collect();
+
+        std::vector<TraceRecord> records;
+        ASSERT_TRUE(TraceRecorder::read_trace(path_.c_str(), &records));
+        ASSERT_EQ(records.size(), 2 * n);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(records[i].op, TRACE_ALLOCATE);
+            EXPECT_EQ(records[i].size, usable);
+            EXPECT_EQ(records[i].address, reinterpret_cast<uintptr_t>(blocks[i]));
+            EXPECT_EQ(records[n + i].op, TRACE_FREE);
+            EXPECT_EQ(records[n + i].address, reinterpret_cast<uintptr_t>(blocks[i]));
+        }
+    });
+    t.join();
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "gc_malloc/TypedPool.hpp"
+#include "gc_malloc/PageGroup.hpp"
+
+namespace {
+
+struct Order {
+    static int live;
+    uint64_t id;
+    double price;
+    char symbol[16];
+
+    explicit Order(uint64_t id_) : id(id_), price(0) { live++; }
+    ~Order() { live--; }
+};
+int Order::live = 0;
+
+BlockHeader* header_of(void* p) {
+    return static_cast<BlockHeader*>(p) - 1;
+}
+
+} // namespace
+
+// =====================================================================
+// 测试 1: 编译期绑定到正确的尺寸类别，块来自该类别的 PageGroup
+// =====================================================================
+TEST(TypedPoolTest, BindsToSizeClassAtCompileTime) {
+    constexpr size_t index = TypedPool<Order>::kSizeClass;
+    static_assert(index == SizeClassInfo::constexpr_index_for(sizeof(Order) + sizeof(BlockHeader)), "");
+    EXPECT_EQ(index, SizeClassInfo::map_size_to_index(sizeof(Order) + sizeof(BlockHeader)));
+
+    Order* o = TypedPool<Order>::create(42);
+    ASSERT_NE(o, nullptr);
+    EXPECT_EQ(o->id, 42u);
+    EXPECT_EQ(Order::live, 1);
+    EXPECT_EQ(header_of(o)->state, STATE_IN_USE);
+    EXPECT_EQ(header_of(o)->owner_group->block_size, SizeClassInfo::get_block_size_for_index(index));
+
+    // 释放的块先进入弹匣，下一次分配直接复用
+    TypedPool<Order>::destroy(o);
+    EXPECT_EQ(Order::live, 0);
+    EXPECT_EQ(TypedPool<Order>::create(7), o);
+    TypedPool<Order>::destroy(o);
+}
+
+// =====================================================================
+// 测试 2: 弹匣溢出的块交还 ThreadHeap，由 GC 回收进 PageGroup
+// =====================================================================
+TEST(TypedPoolTest, OverflowReturnsBlocksToThreadHeap) {
+    std::thread t([]() {
+        ThreadHeap* th = ThreadHeap::GetInstance();
+        const size_t index = TypedPool<Order>::kSizeClass;
+
+        std::vector<void*> blocks;
+        for (int i = 0; i < 200; ++i) {
+            blocks.push_back(TypedPool<Order>::allocate());
+            ASSERT_NE(blocks.back(), nullptr);
+        }
+        const size_t cached_before = TypedPool<Order>::cached();
+        for (void* p : blocks) {
+            TypedPool<Order>::deallocate(p);
+        }
+        EXPECT_LE(TypedPool<Order>::cached(), TypedPool<Order>::kMagazineSize);
+
+        size_t freed = 0;
+        for (void* p : blocks) {
+            freed += header_of(p)->state == STATE_FREED;
+        }
+        EXPECT_EQ(freed, blocks.size() + cached_before - TypedPool<Order>::cached());
+
+        const uint64_t reclaimed_before = th->counters().free_count[index].load();
+        th->garbage_collect();
+        EXPECT_EQ(th->counters().free_count[index].load() - reclaimed_before, freed);
+    });
+    t.join();
+}
@@ -0,0 +1,130 @@
+// 尺寸类别表生成工具：读取 SizeHistogram 导出的直方图或 TraceRecorder
+// 录制的 trace，生成可以通过 -DGC_MALLOC_SIZE_CLASS_TABLE 编译进库的 .def 文件。
+//
+// 用法: gen_size_classes (--histogram <file> | --trace <file>) [options]
+//   --classes <n>    最多生成的类别数（默认与当前表相同）
+//   --max-size <n>   最大类别的块大小，必须是 16 的倍数（默认与当前表的最大类别相同）
+//   -o <file>        输出文件（默认标准输出）
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "gc_malloc/CentralHeap.hpp"
+#include "gc_malloc/SizeClassGenerator.hpp"
+#include "gc_malloc/SizeClassInfo.hpp"
+#include "gc_malloc/SizeHistogram.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/TraceRecorder.hpp"
+
+namespace {
+
+void PrintUsage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s (--histogram <file> | --trace <file>) "
+                 "[--classes <n>] [--max-size <n>] [-o <file>]\n", argv0);
+}
+
+bool LoadHistogram(const char* path, std::vector<SizeHistogramEntry>* out) {
+    FILE* f = std::fopen(path, "r");
+    if (f == nullptr) {
+        return false;
+    }
+    const bool ok = SizeHistogram::read(f, out);
+    std::fclose(f);
+    return ok;
+}
+
+// trace 中的大小是精确值，直接按大小计数，不经过直方图分桶
+bool LoadTrace(const char* path, std::vector<SizeHistogramEntry>* out) {
+    std::vector<TraceRecord> records;
+    if (!TraceRecorder::read_trace(path, &records)) {
+        return false;
+    }
+    std::map<size_t, uint64_t> counts;
+    for (const TraceRecord& r : records) {
+        if (r.op == TRACE_ALLOCATE && r.size > 0) {
+            counts[r.size]++;
+        }
+    }
+    out->clear();
+    for (const auto& kv : counts) {
+        out->push_back({kv.first, kv.second});
+    }
+    return true;
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    const char* histogram_path = nullptr;
+    const char* trace_path = nullptr;
+    const char* output_path = nullptr;
+    SizeClassGeneratorOptions options;
+    options.num_classes = kNumSizeClasses;
+    // 默认覆盖当前表的全部范围（含中等对象），组大小与默认表一样以线程缓存预算的下限为界
+    options.max_block_size = kSizeClassBlockSizes[kNumSizeClasses - 1];
+    options.max_pages = ThreadHeap::kMinThreadCacheBytes / CentralHeap::kPageSize;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--histogram") == 0 && has_value) {
+            histogram_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && has_value) {
+            trace_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--classes") == 0 && has_value) {
+            options.num_classes = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--max-size") == 0 && has_value) {
+            options.max_block_size = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-o") == 0 && has_value) {
+            output_path = argv[++i];
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if ((histogram_path == nullptr) == (trace_path == nullptr)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<SizeHistogramEntry> histogram;
+    const bool loaded = histogram_path != nullptr ? LoadHistogram(histogram_path, &histogram)
+                                                  : LoadTrace(trace_path, &histogram);
+    if (!loaded) {
+        std::fprintf(stderr, "failed to read %s\n", histogram_path != nullptr ? histogram_path : trace_path);
+        return 1;
+    }
+
+    std::vector<GeneratedSizeClass> classes;
+    if (!SizeClassGenerator::generate(histogram, options, &classes)) {
+        std::fprintf(stderr, "invalid options: --classes must be > 0 and --max-size a multiple of %zu\n",
+                     options.alignment);
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (output_path != nullptr) {
+        out = std::fopen(output_path, "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "failed to open %s\n", output_path);
+            return 1;
+        }
+    }
+    SizeClassGenerator::write_table(out, classes);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    std::vector<GeneratedSizeClass> current;
+    SizeClassGenerator::current_classes(&current);
+    std::fprintf(stderr, "classes:                    %zu\n", classes.size());
+    std::fprintf(stderr, "expected waste (current):   %.2f bytes/alloc\n",
+                 SizeClassGenerator::expected_waste(histogram, current));
+    std::fprintf(stderr, "expected waste (generated): %.2f bytes/alloc\n",
+                 SizeClassGenerator::expected_waste(histogram, classes));
+    return 0;
+}
@@ -0,0 +1,228 @@
+// trace 回放工具：读取 TraceRecorder 生成的二进制 trace，
+// 按记录时的线程划分重新驱动 ThreadHeap / CentralHeap，
+// 报告吞吐、碎片率与 RSS，用于离线比较不同尺寸类别表与策略。
+//
+// 用法: trace_replay <trace-file> [--timed] [--stats]
+//   --timed  按记录的时间戳节奏回放（默认尽快回放）
+//   --stats  回放结束后额外输出 HeapStats 报告
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gc_malloc/TraceRecorder.hpp"
+#include "gc_malloc/ThreadHeap.hpp"
+#include "gc_malloc/CentralHeap.hpp"
+#include "gc_malloc/HeapStats.hpp"
+
+namespace {
+
+// 预处理后的单个回放操作。对象用编号而不是地址标识，
+// 因为同一个地址在 trace 中可能被反复分配、释放。
+struct ReplayOp {
+    uint64_t timestamp_ns;
+    uint32_t object;
+    uint64_t size;
+    uint8_t op;
+};
+
+struct ReplayPlan {
+    std::vector<std::vector<ReplayOp>> threads;
+    std::vector<uint64_t> object_sizes;
+    size_t skipped_frees = 0;       // 释放了 trace 开始前分配的对象
+};
+
+ReplayPlan BuildPlan(std::vector<TraceRecord>& records) {
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+
+    ReplayPlan plan;
+    std::unordered_map<uint64_t, uint32_t> live_by_address;
+    std::unordered_map<uint32_t, size_t> thread_index;
+
+    for (const TraceRecord& r : records) {
+        auto it = thread_index.find(r.thread_id);
+        if (it == thread_index.end()) {
+            it = thread_index.emplace(r.thread_id, plan.threads.size()).first;
+            plan.threads.emplace_back();
+        }
+
+        ReplayOp op{r.timestamp_ns, 0, r.size, r.op};
+        if (r.op == TRACE_ALLOCATE) {
+            op.object = static_cast<uint32_t>(plan.object_sizes.size());
+            plan.object_sizes.push_back(r.size);
+            live_by_address[r.address] = op.object;
+        } else if (r.op == TRACE_FREE) {
+            auto live = live_by_address.find(r.address);
+            if (live == live_by_address.end()) {
+                plan.skipped_frees++;
+                continue;
+            }
+            op.object = live->second;
+            live_by_address.erase(live);
+        }
+        plan.threads[it->second].push_back(op);
+    }
+    return plan;
+}
+
+size_t ReadPeakRssBytes() {
+    FILE* f = std::fopen("/proc/self/status", "r");
+    if (f == nullptr) {
+        return 0;
+    }
+    char line[256];
+    size_t kb = 0;
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+        if (std::strncmp(line, "VmHWM:", 6) == 0) {
+            kb = std::strtoull(line + 6, nullptr, 10);
+            break;
+        }
+    }
+    std::fclose(f);
+    return kb * 1024;
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <trace-file> [--timed] [--stats]\n", argv[0]);
+        return 1;
+    }
+
+    bool timed = false;
+    bool print_stats = false;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--timed") == 0) {
+            timed = true;
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            print_stats = true;
+        } else {
+            std::fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<TraceRecord> records;
+    if (!TraceRecorder::read_trace(argv[1], &records)) {
+        std::fprintf(stderr, "failed to read trace: %s\n", argv[1]);
+        return 1;
+    }
+    const ReplayPlan plan = BuildPlan(records);
+
+    // 槽位保存每个对象回放时得到的指针。跨线程释放的对象可能还没被
+    // 分配线程回放到，释放方需要等待槽位被填上。
+    const size_t num_objects = plan.object_sizes.size();
+    std::unique_ptr<std::atomic<void*>[]> slots(new std::atomic<void*>[num_objects]());
+    std::atomic<int64_t> live_requested_bytes{0};
+    std::atomic<size_t> finished_threads{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    for (const std::vector<ReplayOp>& ops : plan.threads) {
+        threads.emplace_back([&, &ops = ops]() {
+            ThreadHeap* heap = ThreadHeap::GetInstance();
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            const auto start = std::chrono::steady_clock::now();
+
+            for (const ReplayOp& op : ops) {
+                if (timed) {
+                    std::this_thread::sleep_until(start + std::chrono::nanoseconds(op.timestamp_ns));
+                }
+                switch (op.op) {
+                case TRACE_ALLOCATE: {
+                    void* p = heap->allocate(op.size == 0 ? 1 : op.size);
+                    if (p == nullptr) {
+                        std::fprintf(stderr, "allocation of %" PRIu64 " bytes failed\n", op.size);
+                        std::abort();
+                    }
+                    live_requested_bytes.fetch_add(op.size, std::memory_order_relaxed);
+                    slots[op.object].store(p, std::memory_order_release);
+                    break;
+                }
+                case TRACE_FREE: {
+                    void* p;
+                    while ((p = slots[op.object].load(std::memory_order_acquire)) == nullptr) {
+                        std::this_thread::yield();
+                    }
+                    live_requested_bytes.fetch_sub(plan.object_sizes[op.object], std::memory_order_relaxed);
+                    ThreadHeap::deallocate(p);
+                    break;
+                }
+                case TRACE_COLLECT:
+                    heap->garbage_collect();
+                    break;
+                default:
+                    break;
+                }
+            }
+            finished_threads.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    // 主线程定期采样 CentralHeap 分发出去的页数，记录峰值以及峰值时刻的碎片率
+    CentralHeap::Stats central;
+    size_t peak_held_bytes = 0;
+    int64_t live_at_peak = 0;
+    auto sample = [&]() {
+        CentralHeap::GetInstance().collect_stats(&central);
+        const size_t held = central.pages_in_use * CentralHeap::kPageSize;
+        if (held > peak_held_bytes) {
+            peak_held_bytes = held;
+            live_at_peak = live_requested_bytes.load(std::memory_order_relaxed);
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    while (finished_threads.load(std::memory_order_acquire) < threads.size()) {
+        sample();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const auto end = std::chrono::steady_clock::now();
+    for (auto& t : threads) {
+        t.join();
+    }
+    sample();
+
+    size_t total_ops = 0;
+    for (const auto& ops : plan.threads) {
+        total_ops += ops.size();
+    }
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    const double fragmentation = peak_held_bytes > 0
+        ? 1.0 - static_cast<double>(std::max<int64_t>(live_at_peak, 0)) / peak_held_bytes
+        : 0.0;
+
+    std::printf("trace:                 %s\n", argv[1]);
+    std::printf("records:               %zu (%zu frees of pre-trace objects skipped)\n", records.size(), plan.skipped_frees);
+    std::printf("threads:               %zu\n", plan.threads.size());
+    std::printf("objects:               %zu\n", num_objects);
+    std::printf("elapsed:               %.6f s%s\n", seconds, timed ? " (timed)" : "");
+    std::printf("throughput:            %.0f ops/s\n", seconds > 0 ? total_ops / seconds : 0.0);
+    std::printf("peak held bytes:       %zu\n", peak_held_bytes);
+    std::printf("live bytes at peak:    %" PRId64 "\n", live_at_peak);
+    std::printf("fragmentation at peak: %.2f%%\n", fragmentation * 100.0);
+    std::printf("final held bytes:      %zu\n", static_cast<size_t>(central.pages_in_use * CentralHeap::kPageSize));
+    std::printf("final mapped bytes:    %zu\n", central.mapped_bytes);
+    std::printf("peak RSS:              %zu\n", ReadPeakRssBytes());
+
+    if (print_stats) {
+        HeapStats::print(stdout);
+    }
+    return 0;
+}